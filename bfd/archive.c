@@ -2304,7 +2304,204 @@ _bfd_write_archive_contents (bfd *arch)
   return false;
 }
 
-/* Note that the namidx for the first symbol is 0.  */
+/* The entries in the symbol map of an input archive which belong to
+   one of its members.  */
+
+struct armap_reuse_entry
+{
+  bfd *member;
+  /* The entries are symdefs[ORDER[FIRST]] to
+     symdefs[ORDER[FIRST + COUNT - 1]] of the member's archive.  */
+  symindex first;
+  symindex count;
+};
+
+/* The symbol map of an input archive, indexed by member.  */
+
+struct armap_reuse
+{
+  bfd *archive;
+  htab_t members;
+  symindex *order;
+};
+
+struct armap_reuse_sort
+{
+  file_ptr file_offset;
+  symindex index;
+};
+
+static int
+armap_reuse_sort_compare (const void *a, const void *b)
+{
+  const struct armap_reuse_sort *sa = (const struct armap_reuse_sort *) a;
+  const struct armap_reuse_sort *sb = (const struct armap_reuse_sort *) b;
+
+  if (sa->file_offset != sb->file_offset)
+    return sa->file_offset < sb->file_offset ? -1 : 1;
+  return sa->index < sb->index ? -1 : sa->index > sb->index;
+}
+
+static hashval_t
+armap_reuse_hash (const void *p)
+{
+  const struct armap_reuse_entry *entry
+    = (const struct armap_reuse_entry *) p;
+
+  return htab_hash_pointer (entry->member);
+}
+
+static int
+armap_reuse_eq (const void *a, const void *b)
+{
+  const struct armap_reuse_entry *ea = (const struct armap_reuse_entry *) a;
+  const struct armap_reuse_entry *eb = (const struct armap_reuse_entry *) b;
+
+  return ea->member == eb->member;
+}
+
+/* Index the symbol map of the input archive IARCH by member into
+   REUSE.  Only members which have already been opened, and so might
+   be copied to the output archive, are indexed.  Return false if the
+   map cannot be used.  */
+
+static bool
+armap_reuse_init (struct armap_reuse *reuse, bfd *iarch)
+{
+  struct artdata *ardata = bfd_ardata (iarch);
+  struct armap_reuse_sort *sorted;
+  symindex count;
+  symindex i, j;
+
+  reuse->archive = iarch;
+  reuse->members = NULL;
+  reuse->order = NULL;
+
+  if (!bfd_has_map (iarch)
+      || bfd_is_thin_archive (iarch)
+      || ardata == NULL
+      || ardata->cache == NULL)
+    return false;
+
+  count = ardata->symdef_count;
+  sorted = (struct armap_reuse_sort *) bfd_malloc ((count + 1)
+						   * sizeof (*sorted));
+  reuse->order = (symindex *) bfd_malloc ((count + 1)
+					  * sizeof (*reuse->order));
+  reuse->members = htab_create_alloc (count / 4 + 1, armap_reuse_hash,
+				      armap_reuse_eq, free, _bfd_calloc_wrapper,
+				      free);
+  if (sorted == NULL || reuse->order == NULL || reuse->members == NULL)
+    {
+      free (sorted);
+      return false;
+    }
+
+  /* Group the map entries by member, keeping their order within each
+     member.  */
+  for (i = 0; i < count; i++)
+    {
+      sorted[i].file_offset = ardata->symdefs[i].file_offset;
+      sorted[i].index = i;
+    }
+  qsort (sorted, count, sizeof (*sorted), armap_reuse_sort_compare);
+
+  for (i = 0; i < count; i = j)
+    {
+      struct armap_reuse_entry *entry;
+      void **slot;
+      bfd *member;
+
+      for (j = i; j < count && sorted[j].file_offset == sorted[i].file_offset;
+	   j++)
+	reuse->order[j] = sorted[j].index;
+
+      member = _bfd_look_for_bfd_in_cache (iarch, sorted[i].file_offset);
+      if (member == NULL)
+	continue;
+
+      entry = (struct armap_reuse_entry *) bfd_malloc (sizeof (*entry));
+      if (entry == NULL)
+	{
+	  free (sorted);
+	  return false;
+	}
+      entry->member = member;
+      entry->first = i;
+      entry->count = j - i;
+      slot = htab_find_slot (reuse->members, entry, INSERT);
+      if (slot == NULL)
+	{
+	  free (entry);
+	  free (sorted);
+	  return false;
+	}
+      free (*slot);
+      *slot = entry;
+    }
+
+  free (sorted);
+  return true;
+}
+
+static void
+armap_reuse_free (struct armap_reuse *reuse)
+{
+  if (reuse->members != NULL)
+    htab_delete (reuse->members);
+  free (reuse->order);
+  reuse->members = NULL;
+  reuse->order = NULL;
+}
+
+/* Add an entry for symbol NAME in ABFD to the map being built by
+   _bfd_compute_and_write_armap.  */
+
+static bool
+add_armap_entry (bfd *arch, struct orl **map, unsigned int *orl_max,
+		 unsigned int *orl_count, int *stridx, const char *name,
+		 bfd *abfd)
+{
+  bfd_size_type namelen;
+  struct orl *new_map;
+  size_t amt;
+
+  if (*orl_count == *orl_max)
+    {
+      *orl_max *= 2;
+      amt = *orl_max * sizeof (struct orl);
+      new_map = (struct orl *) bfd_realloc (*map, amt);
+      if (new_map == NULL)
+	return false;
+
+      *map = new_map;
+    }
+
+  new_map = &(*map)[*orl_count];
+  namelen = strlen (name);
+  amt = sizeof (char *);
+  new_map->name = (char **) bfd_alloc (arch, amt);
+  if (new_map->name == NULL)
+    return false;
+  *(new_map->name) = (char *) bfd_alloc (arch, namelen + 1);
+  if (*(new_map->name) == NULL)
+    return false;
+  strcpy (*(new_map->name), name);
+  new_map->u.abfd = abfd;
+  new_map->namidx = *stridx;
+
+  *stridx += namelen + 1;
+  ++*orl_count;
+  return true;
+}
+
+/* Note that the namidx for the first symbol is 0.
+
+   If ARCH has BFD_ARCHIVE_REUSE_MAP set, members copied unchanged from
+   an input archive with a symbol map get the entries of that map,
+   rather than having their symbols read again.  Members with no
+   entries in the old map are always read, in case the map was out of
+   date.  */
 
 bool
 _bfd_compute_and_write_armap (bfd *arch, unsigned int elength)
@@ -2321,6 +2518,12 @@ _bfd_compute_and_write_armap (bfd *arch, unsigned int elength)
   bool ret;
   size_t amt;
   static bool report_plugin_err = true;
+  struct armap_reuse reuse;
+  bool reuse_ok = false;
+
+  reuse.archive = NULL;
+  reuse.members = NULL;
+  reuse.order = NULL;
 
   /* Dunno if this is the best place for this info...  */
   if (elength != 0)
@@ -2348,6 +2551,37 @@ _bfd_compute_and_write_armap (bfd *arch, unsigned int elength)
        current != NULL;
        current = current->archive_next, elt_no++)
     {
+      if ((arch->flags & BFD_ARCHIVE_REUSE_MAP) != 0
+	  && current->my_archive != NULL)
+	{
+	  if (current->my_archive != reuse.archive)
+	    {
+	      armap_reuse_free (&reuse);
+	      reuse_ok = armap_reuse_init (&reuse, current->my_archive);
+	    }
+	  if (reuse_ok)
+	    {
+	      struct armap_reuse_entry key, *entry;
+
+	      key.member = current;
+	      entry = (struct armap_reuse_entry *) htab_find (reuse.members,
+							      &key);
+	      if (entry != NULL)
+		{
+		  carsym *symdefs = bfd_ardata (reuse.archive)->symdefs;
+		  symindex i;
+
+		  for (i = entry->first; i < entry->first + entry->count; i++)
+		    if (!add_armap_entry (arch, &map, &orl_max, &orl_count,
+					  &stridx,
+					  symdefs[reuse.order[i]].name,
+					  current))
+		      goto error_return;
+		  continue;
+		}
+	    }
+	}
+
       if (bfd_check_format (current, bfd_object)
 	  && (bfd_get_file_flags (current) & HAS_SYMS) != 0)
 	{
@@ -2395,21 +2629,7 @@ _bfd_compute_and_write_armap (bfd *arch, unsigned int elength)
 		       || bfd_is_com_section (sec))
 		      && ! bfd_is_und_section (sec))
 		    {
-		      bfd_size_type namelen;
-		      struct orl *new_map;
-
 		      /* This symbol will go into the archive header.  */
-		      if (orl_count == orl_max)
-			{
-			  orl_max *= 2;
-			  amt = orl_max * sizeof (struct orl);
-			  new_map = (struct orl *) bfd_realloc (map, amt);
-			  if (new_map == NULL)
-			    goto error_return;
-
-			  map = new_map;
-			}
-
 		      if (syms[src_count]->name != NULL
 			  && syms[src_count]->name[0] == '_'
 			  && syms[src_count]->name[1] == '_'
@@ -2423,21 +2643,10 @@ _bfd_compute_and_write_armap (bfd *arch, unsigned int elength)
 			    (_("%pB: plugin needed to handle lto object"),
 			     current);
 			}
-		      namelen = strlen (syms[src_count]->name);
-		      amt = sizeof (char *);
-		      map[orl_count].name = (char **) bfd_alloc (arch, amt);
-		      if (map[orl_count].name == NULL)
+		      if (!add_armap_entry (arch, &map, &orl_max, &orl_count,
+					    &stridx, syms[src_count]->name,
+					    current))
 			goto error_return;
-		      *(map[orl_count].name) = (char *) bfd_alloc (arch,
-								   namelen + 1);
-		      if (*(map[orl_count].name) == NULL)
-			goto error_return;
-		      strcpy (*(map[orl_count].name), syms[src_count]->name);
-		      map[orl_count].u.abfd = current;
-		      map[orl_count].namidx = stridx;
-
-		      stridx += namelen + 1;
-		      ++orl_count;
 		    }
 		}
 	    }
@@ -2453,6 +2662,7 @@ _bfd_compute_and_write_armap (bfd *arch, unsigned int elength)
   ret = BFD_SEND (arch, write_armap,
 		  (arch, elength, map, orl_count, stridx));
 
+  armap_reuse_free (&reuse);
   free (syms);
   free (map);
   if (first_name != NULL)
@@ -2461,6 +2671,7 @@ _bfd_compute_and_write_armap (bfd *arch, unsigned int elength)
   return ret;
 
  error_return:
+  armap_reuse_free (&reuse);
   free (syms);
   free (map);
   if (first_name != NULL)
@@ -1076,6 +1076,10 @@ bool bfd_get_section_contents
 bool bfd_malloc_and_get_section
    (bfd *abfd, asection *section, bfd_byte **buf);
 
+bfd_byte *bfd_map_section_contents
+   (bfd *abfd, asection *section, void **map_addr,
+    bfd_size_type *map_len);
+
 bool bfd_copy_private_section_data
    (bfd *ibfd, asection *isec, bfd *obfd, asection *osec);
 
@@ -1975,6 +1979,10 @@ struct bfd
      BFD retains state information on the file here.  */
   ufile_ptr where;
 
+  /* The whole file, when the caching routines have mapped it into
+     memory for reading.  See bfd_cache_set_mmap.  */
+  struct bfd_cache_map *cache_map;
+
   /* File modified time, if mtime_set is TRUE.  */
   long mtime;
 
@@ -2079,6 +2087,10 @@ struct bfd
   /* Don't generate ELF section header.  */
 #define BFD_NO_SECTION_HEADER  0x800000
 
+  /* When writing an archive symbol map, use the entries of the input
+     archive's map for members copied unchanged from it.  */
+#define BFD_ARCHIVE_REUSE_MAP  0x1000000
+
   /* Flags bits which are for BFD use only.  */
 #define BFD_FLAGS_FOR_BFD_USE_MASK \
   (BFD_IN_MEMORY | BFD_COMPRESS | BFD_DECOMPRESS | BFD_LINKER_CREATED \
@@ -2805,6 +2817,30 @@ bool bfd_cache_close_all (void);
 
 unsigned bfd_cache_size (void);
 
+/* Counters kept by the file cache.  */
+struct bfd_cache_stats
+{
+  /* Files opened, and how many of those were reopened after the
+     cache had closed them to make room for others.  */
+  unsigned long opens;
+  unsigned long reopens;
+
+  /* Files closed to make room for others.  */
+  unsigned long evictions;
+
+  /* Files mapped by the cache, and their total size.  */
+  unsigned long maps;
+  uint64_t mapped_bytes;
+
+  /* Reads served from a mapping, and reads that went to the file.  */
+  unsigned long mapped_reads;
+  unsigned long file_reads;
+};
+
+void bfd_cache_set_mmap (bool enable);
+
+void bfd_cache_get_stats (struct bfd_cache_stats *stats);
+
 /* Extracted from compress.c.  */
 /* Types of compressed DWARF debug sections.  */
 enum compressed_debug_section_type
@@ -2897,6 +2933,10 @@ bool bfd_init_section_compress_status
 bool bfd_compress_section
    (bfd *abfd, asection *section, bfd_byte *uncompressed_buffer);
 
+bool bfd_compress_sections
+   (bfd *abfd, unsigned int count, asection **sections,
+    bfd_byte **uncompressed_buffers);
+
 /* Extracted from corefile.c.  */
 const char *bfd_core_file_failing_command (bfd *abfd);
 
@@ -2978,6 +3018,27 @@ bool bfd_link_check_relocs
 bool _bfd_generic_link_check_relocs
    (bfd *abfd, struct bfd_link_info *info);
 
+/* Counts and timings, in microseconds, of the merging of SEC_MERGE
+   sections.  */
+struct bfd_merge_stats
+{
+  /* Input sections merged and strings or constants read from them.  */
+  unsigned long sections;
+  unsigned long blobs;
+  /* Distinct strings or constants kept.  */
+  unsigned long unique;
+  uint64_t input_bytes;
+  uint64_t output_bytes;
+  /* Most threads used to merge any one set of sections.  */
+  unsigned int threads;
+  uint64_t read_time;
+  uint64_t hash_time;
+  uint64_t insert_time;
+  uint64_t layout_time;
+};
+
+void bfd_merge_get_stats (struct bfd_merge_stats *stats);
+
 bool bfd_merge_private_bfd_data
    (bfd *ibfd, struct bfd_link_info *info);
 
@@ -98,6 +98,10 @@ CODE_FRAGMENT
 .     BFD retains state information on the file here.  *}
 .  ufile_ptr where;
 .
+.  {* The whole file, when the caching routines have mapped it into
+.     memory for reading.  See bfd_cache_set_mmap.  *}
+.  struct bfd_cache_map *cache_map;
+.
 .  {* File modified time, if mtime_set is TRUE.  *}
 .  long mtime;
 .
@@ -203,6 +207,10 @@ CODE_FRAGMENT
 .  {* Don't generate ELF section header.  *}
 .#define BFD_NO_SECTION_HEADER	0x800000
 .
+.  {* When writing an archive symbol map, use the entries of the input
+.     archive's map for members copied unchanged from it.  *}
+.#define BFD_ARCHIVE_REUSE_MAP  0x1000000
+.
 .  {* Flags bits which are for BFD use only.  *}
 .#define BFD_FLAGS_FOR_BFD_USE_MASK \
 .  (BFD_IN_MEMORY | BFD_COMPRESS | BFD_DECOMPRESS | BFD_LINKER_CREATED \
@@ -646,7 +646,10 @@ SYNOPSIS
 DESCRIPTION
 	Return mmap()ed region of the file, if possible and implemented.
 	LEN and OFFSET do not need to be page aligned.  The page aligned
-	address and length are written to MAP_ADDR and MAP_LEN.
+	address and length are written to MAP_ADDR and MAP_LEN.  If the
+	region is part of a mapping of the whole file held by the file
+	cache (see bfd_cache_set_mmap), MAP_ADDR is set to NULL and
+	MAP_LEN to zero, and the region must not be unmapped.
 
 */
 
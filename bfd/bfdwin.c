@@ -211,6 +211,9 @@ bfd_get_file_window (bfd *abfd,
 	  && (abfd->iovec == NULL
 	      || abfd->iovec->bseek (abfd, offset, SEEK_SET) != 0))
 	goto free_and_fail;
+      /* Seeking a file the cache has mapped doesn't reopen it.  */
+      if (abfd->iostream == NULL && bfd_open_file (abfd) == NULL)
+	goto free_and_fail;
 
       fd = fileno ((FILE *) abfd->iostream);
       /* Compute offsets and size for mmap and for the user's data.  */
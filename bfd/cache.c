@@ -125,6 +125,37 @@ static unsigned open_files;
 
 static bfd *bfd_last_cache = NULL;
 
+/* When set by bfd_cache_set_mmap, input files are mapped into memory
+   in their entirety the first time they are read, and all further
+   reads are served from the mapping.  The mapping is independent of
+   the file descriptor, so it survives the file being closed to make
+   room for another, and is only released when the BFD is closed.  */
+
+static bool cache_mmap;
+
+struct bfd_cache_map
+{
+  /* The start of the mapping, and the size of the file when mapped.  */
+  bfd_byte *base;
+  size_t size;
+
+  /* The status of the file, so that bstat need not reopen it.  */
+  struct stat st;
+};
+
+/* Marks a BFD whose file could not be mapped, so that we don't try
+   again on every read.  */
+
+static struct bfd_cache_map cache_map_none;
+
+/* The size of the mappings still in place.  */
+
+static size_t cache_mapped_size;
+
+/* Counters returned by bfd_cache_get_stats.  */
+
+static struct bfd_cache_stats cache_stats;
+
 /* Insert a BFD into the cache.  */
 
 static void
@@ -215,8 +246,11 @@ close_one (void)
       return true;
     }
 
-  to_kill->where = _bfd_real_ftell ((FILE *) to_kill->iostream);
+  /* A mapped file's position is kept in WHERE, not in the stream.  */
+  if (to_kill->cache_map == NULL || to_kill->cache_map == &cache_map_none)
+    to_kill->where = _bfd_real_ftell ((FILE *) to_kill->iostream);
 
+  ++cache_stats.evictions;
   return bfd_cache_delete (to_kill);
 }
 
@@ -277,11 +311,90 @@ bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
   return NULL;
 }
 
+/* Return the mapping of ABFD's file, or NULL if there isn't one.  */
+
+static inline struct bfd_cache_map *
+cache_map_of (bfd *abfd)
+{
+  struct bfd_cache_map *map = abfd->cache_map;
+
+  return map == &cache_map_none ? NULL : map;
+}
+
+/* Try to map the whole of the file open on F for ABFD.  Failure is not
+   an error; reads then simply go to the file as usual.  */
+
+static void
+cache_map_file (bfd *abfd, FILE *f)
+{
+#ifdef HAVE_MMAP
+  struct bfd_cache_map *map;
+  struct stat st;
+  void *base;
+
+  abfd->cache_map = &cache_map_none;
+
+  /* Leave plenty of address space for everything else on hosts where
+     it is scarce.  */
+  if (fstat (fileno (f), &st) != 0
+      || !S_ISREG (st.st_mode)
+      || st.st_size <= 0
+      || (uint64_t) st.st_size > (size_t) -1 / 4 - cache_mapped_size)
+    return;
+
+  base = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno (f), 0);
+  if (base == MAP_FAILED)
+    return;
+
+  map = bfd_malloc (sizeof (*map));
+  if (map == NULL)
+    {
+      munmap (base, st.st_size);
+      return;
+    }
+  map->base = base;
+  map->size = st.st_size;
+  map->st = st;
+  abfd->cache_map = map;
+
+  cache_mapped_size += map->size;
+  ++cache_stats.maps;
+  cache_stats.mapped_bytes += map->size;
+#else
+  (void) f;
+  abfd->cache_map = &cache_map_none;
+#endif
+}
+
+/* Release ABFD's mapping, if it has one.  */
+
+static void
+cache_unmap_file (bfd *abfd)
+{
+  struct bfd_cache_map *map = cache_map_of (abfd);
+
+  abfd->cache_map = NULL;
+  if (map == NULL)
+    return;
+
+#ifdef HAVE_MMAP
+  munmap (map->base, map->size);
+#endif
+  cache_mapped_size -= map->size;
+  free (map);
+}
+
 static file_ptr
 cache_btell (struct bfd *abfd)
 {
   if (!bfd_lock ())
     return -1;
+  if (cache_map_of (abfd) != NULL)
+    {
+      if (!bfd_unlock ())
+	return -1;
+      return abfd->where;
+    }
   FILE *f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
   if (f == NULL)
     {
@@ -300,6 +413,22 @@ cache_bseek (struct bfd *abfd, file_ptr offset, int whence)
 {
   if (!bfd_lock ())
     return -1;
+  if (cache_map_of (abfd) != NULL)
+    {
+      /* Nothing to do but check the new position; bfd_seek updates
+	 WHERE, which is all that mapped reads use.  */
+      if (whence == SEEK_CUR)
+	offset += abfd->where;
+      if (offset < 0)
+	{
+	  errno = EINVAL;
+	  bfd_unlock ();
+	  return -1;
+	}
+      if (!bfd_unlock ())
+	return -1;
+      return 0;
+    }
   FILE *f = bfd_cache_lookup (abfd, whence != SEEK_CUR ? CACHE_NO_SEEK : CACHE_NORMAL);
   if (f == NULL)
     {
@@ -361,14 +490,46 @@ cache_bread (struct bfd *abfd, void *buf, file_ptr nbytes)
     return -1;
   file_ptr nread = 0;
   FILE *f;
+  struct bfd_cache_map *map = cache_map_of (abfd);
 
-  f = bfd_cache_lookup (abfd, CACHE_NORMAL);
-  if (f == NULL)
+  if (map == NULL)
     {
-      bfd_unlock ();
-      return -1;
+      f = bfd_cache_lookup (abfd, CACHE_NORMAL);
+      if (f == NULL)
+	{
+	  bfd_unlock ();
+	  return -1;
+	}
+
+      if (cache_mmap
+	  && abfd->cache_map == NULL
+	  && abfd->direction == read_direction)
+	{
+	  cache_map_file (abfd, f);
+	  map = cache_map_of (abfd);
+	}
     }
 
+  if (map != NULL)
+    {
+      /* Read from the mapping, without going near the file.  */
+      if (abfd->where < map->size)
+	{
+	  nread = map->size - abfd->where;
+	  if (nread > nbytes)
+	    nread = nbytes;
+	  memcpy (buf, map->base + abfd->where, nread);
+	}
+      if (nread < nbytes)
+	bfd_set_error (bfd_error_file_truncated);
+      ++cache_stats.mapped_reads;
+      if (!bfd_unlock ())
+	return -1;
+      return nread;
+    }
+
+  ++cache_stats.file_reads;
+
   /* Some filesystems are unable to handle reads that are too large
      (for instance, NetApp shares with oplocks turned off).  To avoid
      hitting this limitation, we read the buffer in chunks of 8MB max.  */
@@ -433,7 +594,17 @@ static int
 cache_bclose (struct bfd *abfd)
 {
   /* No locking needed here, it's handled by the callee.  */
-  return bfd_cache_close (abfd) - 1;
+  int ret = bfd_cache_close (abfd) - 1;
+
+  if (abfd->cache_map != NULL)
+    {
+      if (!bfd_lock ())
+	return -1;
+      cache_unmap_file (abfd);
+      if (!bfd_unlock ())
+	return -1;
+    }
+  return ret;
 }
 
 static int
@@ -464,6 +635,16 @@ cache_bstat (struct bfd *abfd, struct stat *sb)
   if (!bfd_lock ())
     return -1;
   int sts;
+  struct bfd_cache_map *map = cache_map_of (abfd);
+
+  if (map != NULL)
+    {
+      *sb = map->st;
+      if (!bfd_unlock ())
+	return -1;
+      return 0;
+    }
+
   FILE *f = bfd_cache_lookup (abfd, CACHE_NO_SEEK_ERROR);
 
   if (f == NULL)
@@ -499,10 +680,29 @@ cache_bmmap (struct bfd *abfd ATTRIBUTE_UNUSED,
   else
     {
       static uintptr_t pagesize_m1;
+      struct bfd_cache_map *map = cache_map_of (abfd);
       FILE *f;
       file_ptr pg_offset;
       bfd_size_type pg_len;
 
+      /* A read-only view of a file that is already mapped in full is
+	 served from that mapping, which the caller must not unmap.  */
+      if (map != NULL
+	  && addr == NULL
+	  && (prot & PROT_WRITE) == 0
+	  && offset >= 0
+	  && (bfd_size_type) offset <= map->size
+	  && len <= map->size - offset)
+	{
+	  *map_addr = NULL;
+	  *map_len = 0;
+	  ++cache_stats.mapped_reads;
+	  ret = map->base + offset;
+	  if (!bfd_unlock ())
+	    return (void *) -1;
+	  return ret;
+	}
+
       f = bfd_cache_lookup (abfd, CACHE_NO_SEEK_ERROR);
       if (f == NULL)
 	{
@@ -551,6 +751,9 @@ _bfd_cache_init_unlocked (bfd *abfd)
     }
   abfd->iovec = &cache_iovec;
   insert (abfd);
+  ++cache_stats.opens;
+  if ((abfd->flags & BFD_CLOSED_BY_CACHE) != 0)
+    ++cache_stats.reopens;
   abfd->flags &= ~BFD_CLOSED_BY_CACHE;
   ++open_files;
   return true;
@@ -678,6 +881,77 @@ bfd_cache_size (void)
   return open_files;
 }
 
+/*
+EXTERNAL
+.{* Counters kept by the file cache.  *}
+.struct bfd_cache_stats
+.{
+.  {* Files opened, and how many of those were reopened after the
+.     cache had closed them to make room for others.  *}
+.  unsigned long opens;
+.  unsigned long reopens;
+.
+.  {* Files closed to make room for others.  *}
+.  unsigned long evictions;
+.
+.  {* Files mapped by the cache, and their total size.  *}
+.  unsigned long maps;
+.  uint64_t mapped_bytes;
+.
+.  {* Reads served from a mapping, and reads that went to the file.  *}
+.  unsigned long mapped_reads;
+.  unsigned long file_reads;
+.};
+.
+*/
+
+/*
+FUNCTION
+	bfd_cache_set_mmap
+
+SYNOPSIS
+	void bfd_cache_set_mmap (bool enable);
+
+DESCRIPTION
+	If @var{enable} is true, map each file opened for reading into
+	memory the first time it is read, and serve all further reads
+	from the mapping.  The mapping is kept until the BFD is closed,
+	even if the cache closes the file in the meantime, so reads
+	never need to reopen it.  Files that cannot be mapped are read
+	as usual.  This suits applications like the linker that read
+	many input files, all of them until the end.
+*/
+
+void
+bfd_cache_set_mmap (bool enable)
+{
+  cache_mmap = enable;
+}
+
+/*
+FUNCTION
+	bfd_cache_get_stats
+
+SYNOPSIS
+	void bfd_cache_get_stats (struct bfd_cache_stats *stats);
+
+DESCRIPTION
+	Fill in @var{stats} with the counts of file opens, mappings
+	and reads made by the cache so far.
+*/
+
+void
+bfd_cache_get_stats (struct bfd_cache_stats *stats)
+{
+  if (!bfd_lock ())
+    {
+      memset (stats, 0, sizeof (*stats));
+      return;
+    }
+  *stats = cache_stats;
+  bfd_unlock ();
+}
+
 static FILE *
 _bfd_open_file_unlocked (bfd *abfd)
 {
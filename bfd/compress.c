@@ -23,6 +23,11 @@
 #ifdef HAVE_ZSTD
 #include <zstd.h>
 #endif
+#if defined (HAVE_PTHREAD_H) && defined (HAVE_PTHREAD_CREATE) \
+    && defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+#include <pthread.h>
+#define USE_THREADS 1
+#endif
 #include "bfd.h"
 #include "elf-bfd.h"
 #include "libbfd.h"
@@ -553,6 +558,74 @@ decompress_contents (bool is_zstd, bfd_byte *compressed_buffer,
   return inflateEnd (&strm) == Z_OK && rc == Z_OK && strm.avail_out == 0;
 }
 
+/* Compress UNCOMPRESSED_SIZE bytes at UNCOMPRESSED_BUFFER into
+   COMPRESSED_BUFFER, which has room for *COMPRESSED_SIZE bytes, and
+   set *COMPRESSED_SIZE to the size of the result.  This touches no
+   BFD state, so it may be called from several threads at once.  */
+
+static bool
+compress_contents (bool is_zstd, bfd_byte *uncompressed_buffer,
+		   bfd_size_type uncompressed_size,
+		   bfd_byte *compressed_buffer,
+		   bfd_size_type *compressed_size)
+{
+  if (is_zstd)
+    {
+#ifdef HAVE_ZSTD
+      size_t ret = ZSTD_compress (compressed_buffer, *compressed_size,
+				  uncompressed_buffer, uncompressed_size,
+				  ZSTD_CLEVEL_DEFAULT);
+      if (ZSTD_isError (ret))
+	return false;
+      *compressed_size = ret;
+#endif
+      /* Without zstd support *COMPRESSED_SIZE is left alone, which
+	 leaves the section uncompressed.  */
+      return true;
+    }
+
+  uLong size = *compressed_size;
+  if (compress ((Bytef *) compressed_buffer, &size,
+		(const Bytef *) uncompressed_buffer, uncompressed_size)
+      != Z_OK)
+    return false;
+  *compressed_size = size;
+  return true;
+}
+
+/* Make BUFFER, which holds a compression header and then compressed
+   data, COMPRESSED_SIZE bytes in all, the contents of SEC.  If that
+   is no smaller than the UNCOMPRESSED_SIZE bytes of the current
+   contents, copy those into BUFFER instead and leave SEC uncompressed.
+   The current contents are freed.  */
+
+static void
+install_compressed_contents (bfd *abfd, sec_ptr sec, bfd_byte *buffer,
+			     bfd_size_type compressed_size,
+			     bfd_size_type uncompressed_size)
+{
+  bfd_byte *input_buffer = sec->contents;
+
+  /* If compression didn't make the section smaller, keep it uncompressed.  */
+  if (compressed_size >= uncompressed_size)
+    {
+      memcpy (buffer, input_buffer, uncompressed_size);
+      if (bfd_get_flavour (abfd) == bfd_target_elf_flavour)
+	elf_section_flags (sec) &= ~SHF_COMPRESSED;
+      sec->compress_status = COMPRESS_SECTION_NONE;
+    }
+  else
+    {
+      sec->size = uncompressed_size;
+      bfd_update_compression_header (abfd, buffer, sec);
+      sec->size = compressed_size;
+      sec->compress_status = COMPRESS_SECTION_DONE;
+    }
+  sec->contents = buffer;
+  sec->flags |= SEC_IN_MEMORY;
+  free (input_buffer);
+}
+
 /* Compress section contents using zlib/zstd and store
    as the contents field.  This function assumes the contents
    field was allocated using bfd_malloc() or equivalent.
@@ -564,7 +637,7 @@ static bfd_size_type
 bfd_compress_section_contents (bfd *abfd, sec_ptr sec)
 {
   bfd_byte *input_buffer;
-  uLong compressed_size;
+  bfd_size_type compressed_size;
   bfd_byte *buffer;
   bfd_size_type buffer_size;
   int zlib_size = 0;
@@ -647,25 +720,10 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec)
     }
   else
     {
-      if (abfd->flags & BFD_COMPRESS_ZSTD)
-	{
-#if HAVE_ZSTD
-	  compressed_size = ZSTD_compress (buffer + new_header_size,
-					   compressed_size,
-					   input_buffer,
-					   uncompressed_size,
-					   ZSTD_CLEVEL_DEFAULT);
-	  if (ZSTD_isError (compressed_size))
-	    {
-	      bfd_release (abfd, buffer);
-	      bfd_set_error (bfd_error_bad_value);
-	      return (bfd_size_type) -1;
-	    }
-#endif
-	}
-      else if (compress ((Bytef *) buffer + new_header_size, &compressed_size,
-			 (const Bytef *) input_buffer, uncompressed_size)
-	       != Z_OK)
+      compressed_size -= new_header_size;
+      if (!compress_contents ((abfd->flags & BFD_COMPRESS_ZSTD) != 0,
+			      input_buffer, uncompressed_size,
+			      buffer + new_header_size, &compressed_size))
 	{
 	  bfd_release (abfd, buffer);
 	  bfd_set_error (bfd_error_bad_value);
@@ -675,24 +733,8 @@ bfd_compress_section_contents (bfd *abfd, sec_ptr sec)
       compressed_size += new_header_size;
     }
 
-  /* If compression didn't make the section smaller, keep it uncompressed.  */
-  if (compressed_size >= uncompressed_size)
-    {
-      memcpy (buffer, input_buffer, uncompressed_size);
-      if (bfd_get_flavour (abfd) == bfd_target_elf_flavour)
-	elf_section_flags (sec) &= ~SHF_COMPRESSED;
-      sec->compress_status = COMPRESS_SECTION_NONE;
-    }
-  else
-    {
-      sec->size = uncompressed_size;
-      bfd_update_compression_header (abfd, buffer, sec);
-      sec->size = compressed_size;
-      sec->compress_status = COMPRESS_SECTION_DONE;
-    }
-  sec->contents = buffer;
-  sec->flags |= SEC_IN_MEMORY;
-  free (input_buffer);
+  install_compressed_contents (abfd, sec, buffer, compressed_size,
+			      uncompressed_size);
   return uncompressed_size;
 }
 
@@ -1138,3 +1180,218 @@ bfd_compress_section (bfd *abfd, sec_ptr sec, bfd_byte *uncompressed_buffer)
     }
   return true;
 }
+
+/* Don't start threads unless there is at least this much to compress.  */
+#define COMPRESS_THREADS_MIN_SIZE (1024 * 1024)
+
+/* A section for bfd_compress_sections to compress.  */
+
+struct compress_job
+{
+  bfd_byte *input;
+  bfd_size_type input_size;
+  /* The output, with room for the compression header first.  NULL if
+     the section is left to bfd_compress_section.  */
+  bfd_byte *output;
+  /* The room for compressed data in OUTPUT, then the size of it.  */
+  bfd_size_type output_size;
+  bool ok;
+};
+
+struct compress_jobs
+{
+  struct compress_job *jobs;
+  unsigned int count;
+  unsigned int next;
+  bool is_zstd;
+  int header_size;
+#ifdef USE_THREADS
+  pthread_mutex_t lock;
+#endif
+};
+
+/* Compress jobs from JOBS until there are none left.  */
+
+static void *
+compress_jobs_worker (void *arg)
+{
+  struct compress_jobs *jobs = (struct compress_jobs *) arg;
+
+  for (;;)
+    {
+      struct compress_job *job;
+
+#ifdef USE_THREADS
+      pthread_mutex_lock (&jobs->lock);
+#endif
+      while (jobs->next < jobs->count
+	     && jobs->jobs[jobs->next].output == NULL)
+	jobs->next++;
+      job = jobs->next < jobs->count ? &jobs->jobs[jobs->next++] : NULL;
+#ifdef USE_THREADS
+      pthread_mutex_unlock (&jobs->lock);
+#endif
+      if (job == NULL)
+	return NULL;
+
+      job->ok = compress_contents (jobs->is_zstd, job->input, job->input_size,
+				   job->output + jobs->header_size,
+				   &job->output_size);
+    }
+}
+
+/* Run all of JOBS, which have TOTAL_SIZE bytes of input, on as many
+   threads as there are processors.  */
+
+static void
+run_compress_jobs (struct compress_jobs *jobs,
+		   bfd_size_type total_size ATTRIBUTE_UNUSED)
+{
+#ifdef USE_THREADS
+  long nthreads = 0;
+  long i;
+  pthread_t *threads = NULL;
+
+  if (total_size >= COMPRESS_THREADS_MIN_SIZE)
+    {
+      nthreads = sysconf (_SC_NPROCESSORS_ONLN) - 1;
+      if (nthreads > (long) jobs->count - 1)
+	nthreads = (long) jobs->count - 1;
+    }
+  if (nthreads > 0)
+    threads = (pthread_t *) bfd_malloc (nthreads * sizeof (*threads));
+  if (threads == NULL)
+    nthreads = 0;
+
+  pthread_mutex_init (&jobs->lock, NULL);
+  for (i = 0; i < nthreads; i++)
+    if (pthread_create (&threads[i], NULL, compress_jobs_worker, jobs) != 0)
+      break;
+  nthreads = i;
+
+  /* This thread does its share of the work too, and all of it if no
+     threads could be started.  */
+  compress_jobs_worker (jobs);
+
+  for (i = 0; i < nthreads; i++)
+    pthread_join (threads[i], NULL);
+  pthread_mutex_destroy (&jobs->lock);
+  free (threads);
+#else
+  compress_jobs_worker (jobs);
+#endif
+}
+
+/*
+FUNCTION
+	bfd_compress_sections
+
+SYNOPSIS
+	bool bfd_compress_sections
+	  (bfd *abfd, unsigned int count, asection **sections,
+	   bfd_byte **uncompressed_buffers);
+
+DESCRIPTION
+	Call bfd_compress_section for each of the @var{count}
+	@var{sections} and their @var{uncompressed_buffers}.  Where
+	the host supports threads, the sections are compressed in
+	parallel, with the same result as compressing them one at a
+	time.
+
+	Return @code{FALSE} if compression fails.  Otherwise, return
+	@code{TRUE}.  All of the @var{uncompressed_buffers} are freed
+	in both cases.
+*/
+
+bool
+bfd_compress_sections (bfd *abfd, unsigned int count, asection **sections,
+		       bfd_byte **uncompressed_buffers)
+{
+  struct compress_jobs jobs;
+  bfd_size_type total_size = 0;
+  unsigned int i;
+  bool ret = true;
+
+  jobs.jobs = (struct compress_job *) bfd_zmalloc ((bfd_size_type) count
+						   * sizeof (*jobs.jobs));
+  if (jobs.jobs == NULL && count != 0)
+    {
+      for (i = 0; i < count; i++)
+	free (uncompressed_buffers[i]);
+      return false;
+    }
+  jobs.count = count;
+  jobs.next = 0;
+  jobs.is_zstd = (abfd->flags & BFD_COMPRESS_ZSTD) != 0;
+  jobs.header_size = bfd_get_compression_header_size (abfd, NULL);
+  if (jobs.header_size == 0)
+    jobs.header_size = 12;
+
+  /* Allocate the output for each section which is simply compressed,
+     as bfd_compress_section_contents would.  Anything else, such as
+     contents which are already compressed, is left to
+     bfd_compress_section.  */
+  for (i = 0; i < count; i++)
+    {
+      asection *sec = sections[i];
+      struct compress_job *job = &jobs.jobs[i];
+      int orig_header_size;
+      bfd_size_type uncompressed_size;
+      unsigned int uncompressed_alignment_pow;
+      enum compression_type ch_type = ch_none;
+      bool compressed;
+
+      if (abfd->direction != write_direction
+	  || sec->size == 0
+	  || uncompressed_buffers[i] == NULL
+	  || sec->contents != NULL
+	  || sec->compressed_size != 0
+	  || sec->compress_status != COMPRESS_SECTION_NONE)
+	continue;
+
+      sec->contents = uncompressed_buffers[i];
+      compressed = bfd_is_section_compressed_info (abfd, sec,
+						   &orig_header_size,
+						   &uncompressed_size,
+						   &uncompressed_alignment_pow,
+						   &ch_type);
+      sec->contents = NULL;
+      if (compressed)
+	continue;
+
+      job->input = uncompressed_buffers[i];
+      job->input_size = sec->size;
+      job->output_size = compressBound (sec->size);
+      job->output = bfd_alloc (abfd, job->output_size + jobs.header_size);
+      total_size += sec->size;
+    }
+
+  run_compress_jobs (&jobs, total_size);
+
+  for (i = 0; i < count; i++)
+    {
+      asection *sec = sections[i];
+      struct compress_job *job = &jobs.jobs[i];
+
+      if (!ret)
+	free (uncompressed_buffers[i]);
+      else if (job->output == NULL)
+	ret = bfd_compress_section (abfd, sec, uncompressed_buffers[i]);
+      else if (!job->ok)
+	{
+	  free (uncompressed_buffers[i]);
+	  bfd_set_error (bfd_error_bad_value);
+	  ret = false;
+	}
+      else
+	{
+	  sec->contents = uncompressed_buffers[i];
+	  install_compressed_contents (abfd, sec, job->output,
+				       job->output_size + jobs.header_size,
+				       sec->size);
+	}
+    }
+
+  free (jobs.jobs);
+  return ret;
+}
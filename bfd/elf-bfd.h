@@ -1266,6 +1266,25 @@ struct elf_backend_data
      asection *input_section, bfd_byte *contents, Elf_Internal_Rela *relocs,
      Elf_Internal_Sym *local_syms, asection **local_sections);
 
+  /* The RELOCATE_PREPARE function is called by the ELF backend linker
+     once the output sections have been laid out, before any input
+     section is relocated.  State which RELOCATE_SECTION would
+     otherwise set up on first use should be set up here.  */
+  void (*elf_backend_relocate_prepare)
+    (struct bfd_link_info *info);
+
+  /* The PARALLEL_RELOCATE_P function is called by the ELF backend
+     linker for a non-SEC_ALLOC SEC_DEBUGGING input section with relocs
+     RELOCS.  It returns TRUE if RELOCATE_SECTION may be called for the
+     section on a thread of its own, at the same time as for other such
+     sections.  This requires that relocating the section changes
+     nothing outside of its contents and relocs other than through the
+     link callbacks and _bfd_error_handler, and doesn't return 2.  If
+     this function is NULL, no section is relocated in parallel.  */
+  bool (*elf_backend_parallel_relocate_p)
+    (bfd *input_bfd, asection *input_section,
+     const Elf_Internal_Rela *relocs);
+
   /* The FINISH_DYNAMIC_SYMBOL function is called by the ELF backend
      linker just before it writes a symbol out to the .dynsym section.
      The processor backend may make any required adjustment to the
@@ -7188,6 +7188,20 @@ _bfd_elf_modify_headers (bfd *obfd, struct bfd_link_info *link_info)
   return true;
 }
 
+/* Return TRUE if SHDRP is a DWARF debug section which
+   _bfd_elf_assign_file_positions_for_non_load is to compress.  */
+
+static bool
+elf_compress_section_p (Elf_Internal_Shdr *shdrp)
+{
+  return (shdrp->sh_offset == -1
+	  && shdrp->bfd_section != NULL
+	  && shdrp->sh_type != SHT_REL
+	  && shdrp->sh_type != SHT_RELA
+	  && !bfd_section_is_ctf (shdrp->bfd_section)
+	  && shdrp->sh_name == -1u);
+}
+
 /* Assign file positions for all the reloc sections which are not part
    of the loadable file image, and the file position of section headers.  */
 
@@ -7199,6 +7213,7 @@ _bfd_elf_assign_file_positions_for_non_load (bfd *abfd)
   Elf_Internal_Shdr *shdrp;
   Elf_Internal_Ehdr *i_ehdrp;
   const struct elf_backend_data *bed;
+  unsigned int count;
 
   /* Skip non-load sections without section header.  */
   if ((abfd->flags & BFD_NO_SECTION_HEADER) != 0)
@@ -7208,7 +7223,41 @@ _bfd_elf_assign_file_positions_for_non_load (bfd *abfd)
 
   shdrpp = elf_elfsections (abfd);
   end_shdrpp = shdrpp + elf_numsections (abfd);
+
+  /* Compress DWARF debug sections.  They are all handed over at once,
+     so that they can be compressed in parallel.  */
+  count = 0;
   for (shdrpp++; shdrpp < end_shdrpp; shdrpp++)
+    if (elf_compress_section_p (*shdrpp))
+      count++;
+  if (count != 0)
+    {
+      asection **secs;
+      bfd_byte **buffers;
+      bool ok;
+
+      secs = (asection **) bfd_malloc (count * (sizeof (*secs)
+						+ sizeof (*buffers)));
+      if (secs == NULL)
+	return false;
+      buffers = (bfd_byte **) (secs + count);
+      count = 0;
+      for (shdrpp = elf_elfsections (abfd) + 1;
+	   shdrpp < end_shdrpp;
+	   shdrpp++)
+	if (elf_compress_section_p (*shdrpp))
+	  {
+	    secs[count] = (*shdrpp)->bfd_section;
+	    buffers[count] = (*shdrpp)->contents;
+	    count++;
+	  }
+      ok = bfd_compress_sections (abfd, count, secs, buffers);
+      free (secs);
+      if (!ok)
+	return false;
+    }
+
+  for (shdrpp = elf_elfsections (abfd) + 1; shdrpp < end_shdrpp; shdrpp++)
     {
       shdrp = *shdrpp;
       if (shdrp->sh_offset == -1)
@@ -7229,10 +7278,6 @@ _bfd_elf_assign_file_positions_for_non_load (bfd *abfd)
 	      const char *name = sec->name;
 	      struct bfd_elf_section_data *d;
 
-	      /* Compress DWARF debug sections.  */
-	      if (!bfd_compress_section (abfd, sec, shdrp->contents))
-		return false;
-
 	      if (sec->compress_status == COMPRESS_SECTION_DONE
 		  && (abfd->flags & BFD_COMPRESS_GABI) == 0
 		  && name[1] == 'd')
@@ -2585,6 +2585,43 @@ elf_x86_64_tpoff (struct bfd_link_info *info, bfd_vma address)
   return address - static_tls_size - htab->tls_sec->vma;
 }
 
+/* Return TRUE if the non-SEC_ALLOC section SEC of ABFD, with relocs
+   RELOCS, can be relocated at the same time as others.  Relocs which
+   only compute an address from the symbol value don't change anything
+   shared.  The others may allocate GOT entries, add dynamic relocs or
+   otherwise update the link hash table, so the section is relocated
+   in order with them.  */
+
+static bool
+elf_x86_64_parallel_relocate_p (bfd *abfd ATTRIBUTE_UNUSED,
+				asection *sec,
+				const Elf_Internal_Rela *relocs)
+{
+  const Elf_Internal_Rela *rel, *relend;
+
+  relend = relocs + sec->reloc_count;
+  for (rel = relocs; rel < relend; rel++)
+    switch (ELF32_R_TYPE (rel->r_info) & ~R_X86_64_converted_reloc_bit)
+      {
+      case R_X86_64_NONE:
+      case R_X86_64_64:
+      case R_X86_64_32:
+      case R_X86_64_32S:
+      case R_X86_64_16:
+      case R_X86_64_8:
+      case R_X86_64_PC64:
+      case R_X86_64_PC32:
+      case R_X86_64_PC16:
+      case R_X86_64_PC8:
+      case R_X86_64_DTPOFF64:
+      case R_X86_64_DTPOFF32:
+	break;
+      default:
+	return false;
+      }
+  return true;
+}
+
 /* Relocate an x86_64 ELF section.  */
 
 static int
@@ -2628,8 +2665,6 @@ elf_x86_64_relocate_section (bfd *output_bfd,
   local_got_offsets = elf_local_got_offsets (input_bfd);
   local_tlsdesc_gotents = elf_x86_local_tlsdesc_gotent (input_bfd);
 
-  _bfd_x86_elf_set_tls_module_base (info);
-
   status = true;
   rel = wrel = relocs;
   relend = relocs + input_section->reloc_count;
@@ -5639,6 +5674,8 @@ elf_x86_64_special_sections[]=
 
 #define elf_backend_relocs_compatible	    elf_x86_64_relocs_compatible
 #define elf_backend_always_size_sections    elf_x86_64_always_size_sections
+#define elf_backend_relocate_prepare	    _bfd_x86_elf_set_tls_module_base
+#define elf_backend_parallel_relocate_p	    elf_x86_64_parallel_relocate_p
 #define elf_backend_create_dynamic_sections _bfd_elf_create_dynamic_sections
 #define elf_backend_finish_dynamic_sections elf_x86_64_finish_dynamic_sections
 #define elf_backend_finish_dynamic_symbol   elf_x86_64_finish_dynamic_symbol
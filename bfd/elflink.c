@@ -19,6 +19,11 @@
    MA 02110-1301, USA.  */
 
 #include "sysdep.h"
+#if defined (HAVE_PTHREAD_H) && defined (HAVE_PTHREAD_CREATE) \
+    && defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+#include <pthread.h>
+#define USE_THREADS 1
+#endif
 #include "bfd.h"
 #include "bfdlink.h"
 #include "libbfd.h"
@@ -8778,6 +8783,9 @@ struct elf_final_link_info
   size_t filesym_count;
   /* Local symbol hash table.  */
   struct bfd_hash_table local_hash_table;
+  /* Debugging sections waiting to be relocated in parallel, or NULL
+     if they are relocated as they are seen.  */
+  struct elf_reloc_jobs *reloc_jobs;
 };
 
 struct local_hash_entry
@@ -11084,6 +11092,441 @@ _bfd_elf_check_kept_section (asection *sec, struct bfd_link_info *info)
   return kept;
 }
 
+/* Don't hold more than this many bytes of section contents and relocs
+   waiting to be relocated in parallel.  */
+#define RELOC_JOBS_MAX_SIZE (64 * 1024 * 1024)
+
+/* The local symbols of an input BFD and their sections, as needed to
+   relocate its deferred sections.  These are copies, since
+   elf_final_link_info reuses its buffers for the next input BFD.  */
+
+struct elf_reloc_locals
+{
+  bfd *input_bfd;
+  Elf_Internal_Sym *syms;
+  asection **sections;
+  size_t count;
+  struct elf_reloc_locals *next;
+};
+
+/* A non-SEC_ALLOC debugging section waiting to be relocated.  */
+
+struct elf_reloc_job
+{
+  bfd *input_bfd;
+  asection *section;
+  bfd_byte *contents;
+  Elf_Internal_Rela *relocs;
+  struct elf_reloc_locals *locals;
+  /* Set if relocating the section reported anything, in which case it
+     is relocated again by itself to report it properly.  */
+  bool redo;
+};
+
+struct elf_reloc_jobs
+{
+  bfd *output_bfd;
+  struct bfd_link_info *info;
+  /* The maximum number of threads to relocate on.  */
+  unsigned int threads;
+  struct elf_reloc_job *jobs;
+  size_t count;
+  size_t alloc;
+  /* The number of bytes held by JOBS.  */
+  bfd_size_type size;
+  /* The local symbols used by JOBS, most recently copied first.  */
+  struct elf_reloc_locals *locals;
+  /* The next job for a thread to run.  */
+  size_t next;
+#ifdef USE_THREADS
+  pthread_mutex_t lock;
+#endif
+};
+
+/* The job being run by this thread, if any.  */
+static TLS struct elf_reloc_job *elf_reloc_job_current;
+
+/* The link callbacks and error handler used while relocating in
+   parallel.  Rather than reporting anything, these mark the job being
+   run to be run again once the threads are done.  */
+
+static void
+elf_reloc_job_redo (void)
+{
+  if (elf_reloc_job_current != NULL)
+    elf_reloc_job_current->redo = true;
+}
+
+static void
+elf_reloc_quiet_warning (struct bfd_link_info *info ATTRIBUTE_UNUSED,
+			 const char *warning ATTRIBUTE_UNUSED,
+			 const char *symbol ATTRIBUTE_UNUSED,
+			 bfd *abfd ATTRIBUTE_UNUSED,
+			 asection *section ATTRIBUTE_UNUSED,
+			 bfd_vma address ATTRIBUTE_UNUSED)
+{
+  elf_reloc_job_redo ();
+}
+
+static void
+elf_reloc_quiet_undefined_symbol (struct bfd_link_info *info ATTRIBUTE_UNUSED,
+				  const char *name ATTRIBUTE_UNUSED,
+				  bfd *abfd ATTRIBUTE_UNUSED,
+				  asection *section ATTRIBUTE_UNUSED,
+				  bfd_vma address ATTRIBUTE_UNUSED,
+				  bool is_fatal ATTRIBUTE_UNUSED)
+{
+  elf_reloc_job_redo ();
+}
+
+static void
+elf_reloc_quiet_reloc_overflow (struct bfd_link_info *info ATTRIBUTE_UNUSED,
+				struct bfd_link_hash_entry *entry ATTRIBUTE_UNUSED,
+				const char *name ATTRIBUTE_UNUSED,
+				const char *reloc_name ATTRIBUTE_UNUSED,
+				bfd_vma addend ATTRIBUTE_UNUSED,
+				bfd *abfd ATTRIBUTE_UNUSED,
+				asection *section ATTRIBUTE_UNUSED,
+				bfd_vma address ATTRIBUTE_UNUSED)
+{
+  elf_reloc_job_redo ();
+}
+
+static void
+elf_reloc_quiet_reloc_dangerous (struct bfd_link_info *info ATTRIBUTE_UNUSED,
+				 const char *message ATTRIBUTE_UNUSED,
+				 bfd *abfd ATTRIBUTE_UNUSED,
+				 asection *section ATTRIBUTE_UNUSED,
+				 bfd_vma address ATTRIBUTE_UNUSED)
+{
+  elf_reloc_job_redo ();
+}
+
+static void
+elf_reloc_quiet_message (const char *fmt ATTRIBUTE_UNUSED, ...)
+{
+  elf_reloc_job_redo ();
+}
+
+static void
+elf_reloc_quiet_error_handler (const char *fmt ATTRIBUTE_UNUSED,
+			       va_list ap ATTRIBUTE_UNUSED)
+{
+  elf_reloc_job_redo ();
+}
+
+/* Read the contents of the section of JOB, and its relocs, into memory
+   of its own.  If RELOCS is not NULL, the relocs are copied from
+   there rather than read again.  */
+
+static bool
+elf_reloc_job_read (struct elf_reloc_job *job, struct bfd_link_info *info,
+		    Elf_Internal_Rela *relocs)
+{
+  asection *o = job->section;
+  bfd_size_type amt = (bfd_size_type) o->reloc_count * sizeof (*relocs);
+
+  free (job->contents);
+  job->contents = NULL;
+  free (job->relocs);
+  job->relocs = NULL;
+
+  if (!bfd_get_full_section_contents (job->input_bfd, o, &job->contents))
+    return false;
+
+  if (relocs == NULL)
+    {
+      relocs = _bfd_elf_link_info_read_relocs (job->input_bfd, info, o,
+					       NULL, NULL, false);
+      if (relocs == NULL)
+	return false;
+      if (relocs != elf_section_data (o)->relocs)
+	{
+	  job->relocs = relocs;
+	  return true;
+	}
+    }
+
+  /* The relocs may be changed as the section is relocated, so don't
+     share them.  */
+  job->relocs = (Elf_Internal_Rela *) bfd_malloc (amt);
+  if (job->relocs == NULL)
+    return false;
+  memcpy (job->relocs, relocs, amt);
+  return true;
+}
+
+/* Relocate the section of JOB.  */
+
+static int
+elf_reloc_job_run (struct elf_reloc_jobs *jobs, struct elf_reloc_job *job)
+{
+  const struct elf_backend_data *bed;
+
+  bed = get_elf_backend_data (jobs->output_bfd);
+  return (*bed->elf_backend_relocate_section) (jobs->output_bfd, jobs->info,
+					       job->input_bfd, job->section,
+					       job->contents, job->relocs,
+					       job->locals->syms,
+					       job->locals->sections);
+}
+
+/* Run jobs from JOBS until there are none left.  */
+
+static void *
+elf_reloc_jobs_worker (void *arg)
+{
+  struct elf_reloc_jobs *jobs = (struct elf_reloc_jobs *) arg;
+
+  for (;;)
+    {
+      struct elf_reloc_job *job;
+
+#ifdef USE_THREADS
+      pthread_mutex_lock (&jobs->lock);
+#endif
+      job = jobs->next < jobs->count ? &jobs->jobs[jobs->next++] : NULL;
+#ifdef USE_THREADS
+      pthread_mutex_unlock (&jobs->lock);
+#endif
+      if (job == NULL)
+	break;
+
+      elf_reloc_job_current = job;
+      if (!elf_reloc_job_run (jobs, job))
+	job->redo = true;
+    }
+  elf_reloc_job_current = NULL;
+  return NULL;
+}
+
+#ifdef USE_THREADS
+static void *
+elf_reloc_jobs_thread (void *arg)
+{
+  elf_reloc_jobs_worker (arg);
+  bfd_thread_cleanup ();
+  return NULL;
+}
+#endif
+
+/* Run all of JOBS on up to JOBS->threads threads, but no more than
+   there are processors.  */
+
+static void
+run_reloc_jobs (struct elf_reloc_jobs *jobs)
+{
+#ifdef USE_THREADS
+  long nproc = sysconf (_SC_NPROCESSORS_ONLN);
+  unsigned long nthreads = nproc > 1 ? (unsigned long) nproc : 1;
+  unsigned long i;
+  pthread_t *threads = NULL;
+
+  if (nthreads > jobs->threads)
+    nthreads = jobs->threads;
+  if (nthreads > jobs->count)
+    nthreads = jobs->count;
+  /* Not counting this thread.  */
+  nthreads--;
+  if (nthreads > 0)
+    threads = (pthread_t *) bfd_malloc (nthreads * sizeof (*threads));
+  if (threads == NULL)
+    nthreads = 0;
+
+  jobs->next = 0;
+  pthread_mutex_init (&jobs->lock, NULL);
+  for (i = 0; i < nthreads; i++)
+    if (pthread_create (&threads[i], NULL, elf_reloc_jobs_thread, jobs) != 0)
+      break;
+  nthreads = i;
+
+  /* This thread does its share of the work too, and all of it if no
+     threads could be started.  */
+  elf_reloc_jobs_worker (jobs);
+
+  for (i = 0; i < nthreads; i++)
+    pthread_join (threads[i], NULL);
+  pthread_mutex_destroy (&jobs->lock);
+  free (threads);
+#else
+  jobs->next = 0;
+  elf_reloc_jobs_worker (jobs);
+#endif
+}
+
+/* Free everything held by JOBS, but not JOBS itself.  */
+
+static void
+elf_reloc_jobs_clear (struct elf_reloc_jobs *jobs)
+{
+  struct elf_reloc_locals *locals, *next;
+  size_t i;
+
+  for (i = 0; i < jobs->count; i++)
+    {
+      free (jobs->jobs[i].contents);
+      free (jobs->jobs[i].relocs);
+    }
+  jobs->count = 0;
+  jobs->size = 0;
+
+  for (locals = jobs->locals; locals != NULL; locals = next)
+    {
+      next = locals->next;
+      free (locals->syms);
+      free (locals->sections);
+      free (locals);
+    }
+  jobs->locals = NULL;
+}
+
+static void
+elf_reloc_jobs_free (struct elf_reloc_jobs *jobs)
+{
+  if (jobs == NULL)
+    return;
+  elf_reloc_jobs_clear (jobs);
+  free (jobs->jobs);
+  free (jobs);
+}
+
+/* Relocate the sections waiting in JOBS and write them out, in the
+   order they were deferred.  Nothing is reported while the threads
+   run.  Sections for which something would have been reported are
+   relocated again afterwards, one at a time, so that the diagnostics
+   and the output are the same as without threads.  */
+
+static bool
+elf_reloc_jobs_flush (struct elf_reloc_jobs *jobs)
+{
+  struct bfd_link_info *info = jobs->info;
+  bfd *output_bfd = jobs->output_bfd;
+  const struct bfd_link_callbacks *callbacks;
+  struct bfd_link_callbacks quiet;
+  bfd_error_handler_type error_handler;
+  size_t i;
+  bool ret = true;
+
+  if (jobs->count == 0)
+    return true;
+
+  callbacks = info->callbacks;
+  quiet = *callbacks;
+  quiet.warning = elf_reloc_quiet_warning;
+  quiet.undefined_symbol = elf_reloc_quiet_undefined_symbol;
+  quiet.reloc_overflow = elf_reloc_quiet_reloc_overflow;
+  quiet.reloc_dangerous = elf_reloc_quiet_reloc_dangerous;
+  quiet.unattached_reloc = elf_reloc_quiet_reloc_dangerous;
+  quiet.einfo = elf_reloc_quiet_message;
+  quiet.info = elf_reloc_quiet_message;
+  quiet.minfo = elf_reloc_quiet_message;
+  info->callbacks = &quiet;
+  error_handler = bfd_set_error_handler (elf_reloc_quiet_error_handler);
+
+  run_reloc_jobs (jobs);
+
+  bfd_set_error_handler (error_handler);
+  info->callbacks = callbacks;
+
+  for (i = 0; ret && i < jobs->count; i++)
+    {
+      struct elf_reloc_job *job = &jobs->jobs[i];
+      asection *o = job->section;
+
+      if (job->redo
+	  && (!elf_reloc_job_read (job, info, NULL)
+	      || !elf_reloc_job_run (jobs, job)))
+	ret = false;
+      else if (!bfd_set_section_contents (output_bfd, o->output_section,
+					  job->contents,
+					  ((file_ptr) o->output_offset
+					   * bfd_octets_per_byte (output_bfd,
+								  o)),
+					  o->size))
+	ret = false;
+    }
+
+  elf_reloc_jobs_clear (jobs);
+  return ret;
+}
+
+/* Defer relocating section O of INPUT_BFD, whose relocs have been read
+   into RELOCS, to be done in parallel with others.  ISYMBUF and
+   SECTIONS are the LOCSYMCOUNT local symbols of INPUT_BFD and their
+   sections.  */
+
+static bool
+elf_link_defer_relocate (struct elf_final_link_info *flinfo,
+			 bfd *input_bfd, asection *o,
+			 Elf_Internal_Rela *relocs,
+			 Elf_Internal_Sym *isymbuf, size_t locsymcount)
+{
+  struct elf_reloc_jobs *jobs = flinfo->reloc_jobs;
+  struct elf_reloc_locals *locals;
+  struct elf_reloc_job *job;
+
+  /* elf_link_input_bfd flushes JOBS before it changes any symbol, so
+     the local symbols only need copying once for each input BFD.  */
+  locals = jobs->locals;
+  if (locals == NULL || locals->input_bfd != input_bfd)
+    {
+      size_t i;
+
+      locals = (struct elf_reloc_locals *) bfd_zmalloc (sizeof (*locals));
+      if (locals == NULL)
+	return false;
+      locals->input_bfd = input_bfd;
+      locals->count = locsymcount;
+      locals->next = jobs->locals;
+      jobs->locals = locals;
+      if (locsymcount != 0)
+	{
+	  locals->syms = (Elf_Internal_Sym *)
+	    bfd_malloc (locsymcount * sizeof (*isymbuf));
+	  locals->sections = (asection **)
+	    bfd_malloc (locsymcount * sizeof (*flinfo->sections));
+	  if (locals->syms == NULL || locals->sections == NULL)
+	    return false;
+	  memcpy (locals->syms, isymbuf, locsymcount * sizeof (*isymbuf));
+	  memcpy (locals->sections, flinfo->sections,
+		  locsymcount * sizeof (*flinfo->sections));
+	}
+
+      /* Offsets in SEC_MERGE sections are looked up in a map which is
+	 otherwise built on first use.  */
+      for (i = 0; i < locsymcount; i++)
+	if (locals->sections[i] != NULL
+	    && locals->sections[i]->sec_info_type == SEC_INFO_TYPE_MERGE)
+	  _bfd_merged_section_prepare
+	    (elf_section_data (locals->sections[i])->sec_info);
+    }
+
+  if (jobs->count == jobs->alloc)
+    {
+      size_t alloc = jobs->alloc ? jobs->alloc * 2 : 64;
+      struct elf_reloc_job *p;
+
+      p = (struct elf_reloc_job *) bfd_realloc (jobs->jobs,
+						alloc * sizeof (*p));
+      if (p == NULL)
+	return false;
+      jobs->jobs = p;
+      jobs->alloc = alloc;
+    }
+  job = &jobs->jobs[jobs->count++];
+  memset (job, 0, sizeof (*job));
+  job->input_bfd = input_bfd;
+  job->section = o;
+  job->locals = locals;
+  if (!elf_reloc_job_read (job, flinfo->info, relocs))
+    return false;
+
+  jobs->size += o->size + o->reloc_count * sizeof (*relocs);
+  if (jobs->size >= RELOC_JOBS_MAX_SIZE)
+    return elf_reloc_jobs_flush (jobs);
+  return true;
+}
+
 /* Link an input file into the linker output file.  This function
    handles all the sections and relocations of the input file at once.
    This is so that we only have to read the local symbols once, and
@@ -11111,6 +11554,7 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
   bfd_vma r_type_mask;
   int r_sym_shift;
   bool have_file_sym = false;
+  bool defer_debug;
 
   output_bfd = flinfo->output_bfd;
   bed = get_elf_backend_data (output_bfd);
@@ -11340,11 +11784,26 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
       address_size = 8;
     }
 
+  /* Relocations against local IFUNC symbols update the backend's
+     table of them, so the debugging sections of such a file are not
+     deferred.  Otherwise read the local symbol names now, as they are
+     read on first use.  */
+  defer_debug = flinfo->reloc_jobs != NULL;
+  for (isym = isymbuf; defer_debug && isym < isymend; isym++)
+    if (ELF_ST_TYPE (isym->st_info) == STT_GNU_IFUNC)
+      defer_debug = false;
+  if (defer_debug
+      && locsymcount != 0
+      && bfd_elf_string_from_elf_section (input_bfd, symtab_hdr->sh_link,
+					  0) == NULL)
+    defer_debug = false;
+
   /* Relocate the contents of each section.  */
   sym_hashes = elf_sym_hashes (input_bfd);
   for (o = input_bfd->sections; o != NULL; o = o->next)
     {
       bfd_byte *contents;
+      bool defer;
 
       if (! o->linker_mark)
 	{
@@ -11429,6 +11888,17 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 	  continue;
 	}
 
+      /* Non-SEC_ALLOC debugging sections may be relocated in
+	 parallel, once all of them have been seen.  */
+      defer = (defer_debug
+	       && ((o->flags & (SEC_ALLOC | SEC_DEBUGGING | SEC_RELOC
+				| SEC_EXCLUDE | SEC_ELF_REVERSE_COPY))
+		   == (SEC_DEBUGGING | SEC_RELOC))
+	       && o->size != 0
+	       && o->reloc_count != 0
+	       && o->sec_info_type == SEC_INFO_TYPE_NONE
+	       && elf_section_data (o)->this_hdr.contents == NULL);
+
       /* Get the contents of the section.  They have been cached by a
 	 relaxation routine.  Note that o is a section in an input
 	 file, so the contents field will not have been set by any of
@@ -11451,6 +11921,9 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 	   contents anymore, they have been recorded earlier.  Except
 	   if the backend has special provisions for writing sections.  */
 	contents = NULL;
+      else if (defer)
+	/* Read by elf_link_defer_relocate.  */
+	contents = NULL;
       else
 	{
 	  contents = flinfo->contents;
@@ -11581,7 +12054,11 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 				    isymbuf, locsymcount, s_type == STT_SRELC))
 		    return false;
 
-		  /* Symbol evaluated OK.  Update to absolute value.  */
+		  /* Symbol evaluated OK.  Update to absolute value.
+		     Sections already deferred must see the old value.  */
+		  if (flinfo->reloc_jobs != NULL
+		      && !elf_reloc_jobs_flush (flinfo->reloc_jobs))
+		    return false;
 		  set_symbol_value (input_bfd, isymbuf, locsymcount,
 				    r_symndx, val);
 		  continue;
@@ -11615,6 +12092,9 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 							      flinfo->info);
 			  if (kept != NULL)
 			    {
+			      if (flinfo->reloc_jobs != NULL
+				  && !elf_reloc_jobs_flush (flinfo->reloc_jobs))
+				return false;
 			      *ps = kept;
 			      continue;
 			    }
@@ -11623,6 +12103,26 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 		}
 	    }
 
+	  if (defer
+	      && bed->elf_backend_parallel_relocate_p (input_bfd, o,
+						       internal_relocs))
+	    {
+	      if (!elf_link_defer_relocate (flinfo, input_bfd, o,
+					    internal_relocs, isymbuf,
+					    locsymcount))
+		return false;
+	      continue;
+	    }
+
+	  /* The backend needs the section relocated in order after
+	     all, so read it now.  */
+	  if (defer)
+	    {
+	      contents = flinfo->contents;
+	      if (!bfd_get_full_section_contents (input_bfd, o, &contents))
+		return false;
+	    }
+
 	  /* Relocate the section by invoking a back end routine.
 
 	     The back end routine is responsible for adjusting the
@@ -12317,6 +12817,7 @@ elf_final_link_free (bfd *obfd, struct elf_final_link_info *flinfo)
   free (flinfo->sections);
   if (flinfo->symshndxbuf != (Elf_External_Sym_Shndx *) -1)
     free (flinfo->symshndxbuf);
+  elf_reloc_jobs_free (flinfo->reloc_jobs);
   for (o = obfd->sections; o != NULL; o = o->next)
     {
       struct bfd_elf_section_data *esdo = elf_section_data (o);
@@ -12739,6 +13240,24 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
       && bed->elf_backend_elfsym_local_is_section (abfd))
     symtab_hdr->sh_info = bfd_get_symcount (abfd);
 
+#ifdef USE_THREADS
+  /* Relocate debugging sections in parallel if the backend allows it.
+     When relocs are emitted they need to be done in order.  */
+  if (info->threads > 1
+      && bed->elf_backend_parallel_relocate_p != NULL
+      && bed->elf_backend_write_section == NULL
+      && !emit_relocs)
+    {
+      flinfo.reloc_jobs = (struct elf_reloc_jobs *)
+	bfd_zmalloc (sizeof (*flinfo.reloc_jobs));
+      if (flinfo.reloc_jobs == NULL)
+	goto error_return;
+      flinfo.reloc_jobs->output_bfd = abfd;
+      flinfo.reloc_jobs->info = info;
+      flinfo.reloc_jobs->threads = info->threads;
+    }
+#endif
+
   /* Allocate some memory to hold information read in from the input
      files.  */
   if (max_contents_size != 0)
@@ -12824,6 +13343,9 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
       htab->tls_size = end - base;
     }
 
+  if (bed->elf_backend_relocate_prepare != NULL)
+    bed->elf_backend_relocate_prepare (info);
+
   if (!_bfd_elf_fixup_eh_frame_hdr (info))
     return false;
 
@@ -12920,6 +13442,10 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
 	}
     }
 
+  if (flinfo.reloc_jobs != NULL
+      && !elf_reloc_jobs_flush (flinfo.reloc_jobs))
+    goto error_return;
+
   /* Free symbol buffer if needed.  */
   if (!info->reduce_memory_overheads)
     {
@@ -502,6 +502,12 @@
 #ifndef elf_backend_relocate_section
 #define elf_backend_relocate_section	0
 #endif
+#ifndef elf_backend_relocate_prepare
+#define elf_backend_relocate_prepare	0
+#endif
+#ifndef elf_backend_parallel_relocate_p
+#define elf_backend_parallel_relocate_p	0
+#endif
 #ifndef elf_backend_finish_dynamic_symbol
 #define elf_backend_finish_dynamic_symbol	0
 #endif
@@ -858,6 +864,8 @@ static const struct elf_backend_data elfNN_bed =
   elf_backend_strip_zero_sized_dynamic_sections,
   elf_backend_init_index_section,
   elf_backend_relocate_section,
+  elf_backend_relocate_prepare,
+  elf_backend_parallel_relocate_p,
   elf_backend_finish_dynamic_symbol,
   elf_backend_finish_dynamic_sections,
   elf_backend_begin_write_processing,
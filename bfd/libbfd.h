@@ -726,10 +726,18 @@ extern bool _bfd_write_merged_section
 extern bfd_vma _bfd_merged_section_offset
   (bfd *, asection **, void *, bfd_vma) ATTRIBUTE_HIDDEN;
 
+/* Prepare a SEC_MERGE section for offsets to be looked up in it.  */
+
+extern void _bfd_merged_section_prepare (void *) ATTRIBUTE_HIDDEN;
+
 /* Tidy up when done.  */
 
 extern void _bfd_merge_sections_free (void *) ATTRIBUTE_HIDDEN;
 
+/* Return the counts and timings of merging so far.  */
+
+extern void _bfd_merge_get_stats (struct bfd_merge_stats *) ATTRIBUTE_HIDDEN;
+
 /* Macros to tell if bfds are read or write enabled.
 
    Note that bfds open for read may be scribbled into if the fd passed
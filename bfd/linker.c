@@ -3391,6 +3391,48 @@ _bfd_generic_link_check_relocs (bfd *abfd ATTRIBUTE_UNUSED,
   return true;
 }
 
+/*
+EXTERNAL
+.{* Counts and timings, in microseconds, of the merging of SEC_MERGE
+.   sections.  *}
+.struct bfd_merge_stats
+.{
+.  {* Input sections merged and strings or constants read from them.  *}
+.  unsigned long sections;
+.  unsigned long blobs;
+.  {* Distinct strings or constants kept.  *}
+.  unsigned long unique;
+.  uint64_t input_bytes;
+.  uint64_t output_bytes;
+.  {* Most threads used to merge any one set of sections.  *}
+.  unsigned int threads;
+.  uint64_t read_time;
+.  uint64_t hash_time;
+.  uint64_t insert_time;
+.  uint64_t layout_time;
+.};
+.
+*/
+
+/*
+FUNCTION
+	bfd_merge_get_stats
+
+SYNOPSIS
+	void bfd_merge_get_stats (struct bfd_merge_stats *stats);
+
+DESCRIPTION
+	Fill in @var{stats} with the counts and timings of the merging
+	of SEC_MERGE sections done by <<bfd_merge_sections>> so far in
+	this process.
+*/
+
+void
+bfd_merge_get_stats (struct bfd_merge_stats *stats)
+{
+  _bfd_merge_get_stats (stats);
+}
+
 /*
 FUNCTION
 	bfd_merge_private_bfd_data
@@ -25,6 +25,12 @@
 
 #include "sysdep.h"
 #include <limits.h>
+#include <sys/time.h>
+#if defined (HAVE_PTHREAD_H) && defined (HAVE_PTHREAD_CREATE) \
+    && defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+#include <pthread.h>
+#define USE_THREADS 1
+#endif
 #include "bfd.h"
 #include "elf-bfd.h"
 #include "libbfd.h"
@@ -92,6 +98,11 @@ struct sec_merge_hash
      i (which is pointed to be values[i]).  */
   uint64_t *key_lens;
   struct sec_merge_hash_entry **values;
+  /* If NSHARDS is more than one, the entries are held by SHARDS rather
+     than this table, except for those in SHARDS[0], which is this
+     table.  FIRST, LAST and SIZE still describe all of the entries.  */
+  unsigned int nshards;
+  struct sec_merge_hash **shards;
 };
 
 /* True when given NEWCOUNT and NBUCKETS indicate that the hash table needs
@@ -368,7 +379,8 @@ hashit (struct sec_merge_hash *table, const char *string, unsigned int *plen)
 }
 
 /* Lookup or insert a blob STRING (of length LEN, precomputed HASH and
-   input ALIGNMENT) into TABLE.  Return the found or new hash table entry.  */
+   input ALIGNMENT) into TABLE.  Return the found or new hash table entry.
+   New entries are not added to the list of entries of TABLE.  */
 
 static struct sec_merge_hash_entry *
 sec_merge_hash_lookup (struct sec_merge_hash *table, const char *string,
@@ -406,14 +418,6 @@ sec_merge_hash_lookup (struct sec_merge_hash *table, const char *string,
     return NULL;
   hashp->alignment = alignment;
 
-  table->size++;
-  BFD_ASSERT (table->size == table->table.count);
-  if (table->first == NULL)
-    table->first = hashp;
-  else
-    table->last->next = hashp;
-  table->last = hashp;
-
   return hashp;
 }
 
@@ -440,6 +444,8 @@ sec_merge_init (unsigned int entsize, bool strings)
   table->last = NULL;
   table->entsize = entsize;
   table->strings = strings;
+  table->nshards = 1;
+  table->shards = NULL;
 
   table->nbuckets = 0x2000;
   table->key_lens = objalloc_alloc ((struct objalloc *) table->table.memory,
@@ -697,105 +703,460 @@ _bfd_add_merge_section (bfd *abfd, void **psinfo, asection *sec,
   return false;
 }
 
-/* Record one whole input section (described by SECINFO) into the hash table
-   SINFO.  */
+/* Don't enter the sections of a merge_info on several threads unless
+   they add up to at least this many bytes.  */
+#define MERGE_THREADS_MIN_SIZE (1024 * 1024)
+
+/* When entering sections on several threads, the hash table is split
+   into 1 << MERGE_SHARD_BITS tables, chosen by the top bits of the hash
+   code, so that each can be filled by one thread.  */
+#define MERGE_SHARD_BITS 4
+#define MERGE_SHARD(TABLE, HASH) \
+  ((TABLE)->nshards > 1 ? (HASH) >> (32 - MERGE_SHARD_BITS) : 0)
+
+/* And no more than this many bytes of section contents are read in to
+   be entered at once.  */
+#define MERGE_BATCH_SIZE (64 * 1024 * 1024)
+
+static struct bfd_merge_stats merge_stats;
+
+/* Return the time of day in microseconds.  */
+
+static uint64_t
+merge_clock (void)
+{
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return (uint64_t) tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+/* An input section to be entered into the hash table of its
+   merge_info.  */
+
+struct merge_job
+{
+  struct sec_merge_sec_info *secinfo;
+  bfd_byte *contents;
+  /* For each blob in the section, its hash code in the upper 32 bits
+     and its length in the lower 32 bits.  The offsets of the blobs are
+     in the map_ofs array of SECINFO.  */
+  uint64_t *hash_lens;
+  /* The indices of the blobs sorted by the shard of the hash table they
+     belong in, keeping their order within each shard, or NULL if the
+     hash table is not split.  The blobs of shard S are those from
+     SHARD_START[S] up to SHARD_START[S + 1].  */
+  unsigned int *shard_blobs;
+  unsigned int shard_start[(1 << MERGE_SHARD_BITS) + 1];
+  bool ok;
+};
+
+struct merge_jobs
+{
+  struct sec_merge_hash *htab;
+  struct merge_job *jobs;
+  unsigned int count;
+  /* The next job, or the next shard of HTAB, for a thread to take.  */
+  unsigned int next;
+  unsigned int limit;
+  bool ok;
+#ifdef USE_THREADS
+  pthread_mutex_t lock;
+#endif
+};
+
+/* Take the next unit of work from JOBS.  Return -1 if there is none
+   left.  */
+
+static int
+merge_jobs_take (struct merge_jobs *jobs)
+{
+  int ret = -1;
+
+#ifdef USE_THREADS
+  pthread_mutex_lock (&jobs->lock);
+#endif
+  if (jobs->next < jobs->limit)
+    ret = jobs->next++;
+#ifdef USE_THREADS
+  pthread_mutex_unlock (&jobs->lock);
+#endif
+  return ret;
+}
+
+/* Find the blobs of the section of JOB, calculating their hash codes
+   and lengths and recording their offsets.  If HTAB is split, also
+   sort the blobs by shard.  */
 
 static bool
-record_section (struct sec_merge_info *sinfo,
-		struct sec_merge_sec_info *secinfo)
+hash_section (struct sec_merge_hash *htab, struct merge_job *job)
 {
+  struct sec_merge_sec_info *secinfo = job->secinfo;
   asection *sec = secinfo->sec;
-  struct sec_merge_hash_entry *entry;
   unsigned char *p, *end;
-  bfd_vma mask, eltalign;
-  unsigned int align;
-  bfd_size_type amt;
-  bfd_byte *contents;
-  void *tmpptr;
-
-  amt = sec->size;
-  if (sec->flags & SEC_STRINGS)
-    /* Some versions of gcc may emit a string without a zero terminator.
-       See http://gcc.gnu.org/ml/gcc-patches/2006-06/msg01004.html
-       Allocate space for an extra zero.  */
-    amt += sec->entsize;
-  contents = bfd_malloc (amt);
-  if (!contents)
-    goto error_return;
+  unsigned int n, alloc, i, s;
+  unsigned int next[1 << MERGE_SHARD_BITS];
 
-  /* Slurp in all section contents (possibly decompressing it).  */
-  sec->rawsize = sec->size;
-  if (sec->flags & SEC_STRINGS)
-    memset (contents + sec->size, 0, sec->entsize);
-  if (! bfd_get_full_section_contents (sec->owner, sec, &contents))
-    goto error_return;
+  alloc = 0;
+  end = job->contents + sec->size;
+  for (p = job->contents, n = 0; p < end; n++)
+    {
+      unsigned int len;
+      uint32_t hash = hashit (htab, (char *) p, &len);
 
-  /* Now populate the hash table and offset mapping.  */
+      if (n == alloc)
+	{
+	  alloc = alloc ? alloc * 2 : 1024;
+	  job->hash_lens = bfd_realloc_or_free (job->hash_lens,
+						alloc * sizeof (uint64_t));
+	  if (job->hash_lens == NULL)
+	    return false;
+	}
+      job->hash_lens[n] = ((uint64_t) hash << 32) | len;
+      if (! append_offsetmap (secinfo, p - job->contents, NULL))
+	return false;
+      p += len;
+    }
 
-  /* Presize the hash table for what we're going to add.  We overestimate
-     quite a bit, but if it turns out to be too much then other sections
-     merged into this area will make use of that as well.  */
-  if (!sec_merge_maybe_resize (sinfo->htab, 1 + sec->size / 2))
+  memset (job->shard_start, 0, sizeof (job->shard_start));
+  if (htab->nshards <= 1)
+    {
+      job->shard_start[1] = n;
+      return true;
+    }
+
+  job->shard_blobs = bfd_malloc ((n ? n : 1) * sizeof (*job->shard_blobs));
+  if (job->shard_blobs == NULL)
+    return false;
+  for (i = 0; i < n; i++)
+    {
+      s = MERGE_SHARD (htab, (uint32_t) (job->hash_lens[i] >> 32));
+      job->shard_start[s + 1]++;
+    }
+  for (s = 0; s < htab->nshards; s++)
+    {
+      job->shard_start[s + 1] += job->shard_start[s];
+      next[s] = job->shard_start[s];
+    }
+  for (i = 0; i < n; i++)
+    {
+      s = MERGE_SHARD (htab, (uint32_t) (job->hash_lens[i] >> 32));
+      job->shard_blobs[next[s]++] = i;
+    }
+  return true;
+}
+
+static void *
+hash_sections_worker (void *arg)
+{
+  struct merge_jobs *jobs = (struct merge_jobs *) arg;
+  int i;
+
+  while ((i = merge_jobs_take (jobs)) >= 0)
+    jobs->jobs[i].ok = hash_section (jobs->htab, &jobs->jobs[i]);
+  return NULL;
+}
+
+/* Enter the blobs of all of JOBS that belong in SHARD of their hash
+   table, in the order they appear, and record the entries they map
+   to.  */
+
+static bool
+enter_shard (struct merge_jobs *jobs, unsigned int shard)
+{
+  struct sec_merge_hash *htab = jobs->htab;
+  struct sec_merge_hash *table;
+  unsigned int added = 0;
+  unsigned int j, k;
+
+  table = htab->nshards > 1 ? htab->shards[shard] : htab;
+
+  for (j = 0; j < jobs->count; j++)
+    added += (jobs->jobs[j].shard_start[shard + 1]
+	      - jobs->jobs[j].shard_start[shard]);
+  if (!sec_merge_maybe_resize (table, added))
     {
       bfd_set_error (bfd_error_no_memory);
-      goto error_return;
+      return false;
     }
 
-  /* Walk through the contents, calculate hashes and length of all
-     blobs (strings or fixed-size entries) we find and fill the
-     hash and offset tables.  */
-  align = sec->alignment_power;
-  mask = ((bfd_vma) 1 << align) - 1;
-  end = contents + sec->size;
-  for (p = contents; p < end;)
+  for (j = 0; j < jobs->count; j++)
     {
-      unsigned len;
-      uint32_t hash = hashit (sinfo->htab, (char*) p, &len);
-      unsigned int ofs = p - contents;
-      eltalign = ofs;
-      eltalign = ((eltalign ^ (eltalign - 1)) + 1) >> 1;
-      if (!eltalign || eltalign > mask)
-	eltalign = mask + 1;
-      entry = sec_merge_hash_lookup (sinfo->htab, (char *) p, len, hash,
-				     (unsigned) eltalign);
-      if (! entry)
-	goto error_return;
-      if (! append_offsetmap (secinfo, ofs, entry))
-	goto error_return;
-      p += len;
+      struct merge_job *job = &jobs->jobs[j];
+      struct sec_merge_sec_info *secinfo = job->secinfo;
+      bfd_vma mask, eltalign;
+
+      mask = ((bfd_vma) 1 << secinfo->sec->alignment_power) - 1;
+      for (k = job->shard_start[shard]; k < job->shard_start[shard + 1]; k++)
+	{
+	  unsigned int i = job->shard_blobs ? job->shard_blobs[k] : k;
+	  uint64_t hash_len = job->hash_lens[i];
+	  uint32_t hash = hash_len >> 32;
+	  unsigned int ofs = MAP_OFS (secinfo, i);
+	  struct sec_merge_hash_entry *entry;
+
+	  eltalign = ofs;
+	  eltalign = ((eltalign ^ (eltalign - 1)) + 1) >> 1;
+	  if (!eltalign || eltalign > mask)
+	    eltalign = mask + 1;
+	  entry = sec_merge_hash_lookup (table, (char *) job->contents + ofs,
+					 (uint32_t) hash_len, hash,
+					 (unsigned) eltalign);
+	  if (! entry)
+	    return false;
+	  secinfo->map[i].entry = entry;
+	}
+    }
+  return true;
+}
+
+static void *
+enter_shards_worker (void *arg)
+{
+  struct merge_jobs *jobs = (struct merge_jobs *) arg;
+  bool ok = true;
+  int i;
+
+  while ((i = merge_jobs_take (jobs)) >= 0)
+    if (!enter_shard (jobs, i))
+      ok = false;
+
+  if (!ok)
+    {
+#ifdef USE_THREADS
+      pthread_mutex_lock (&jobs->lock);
+#endif
+      jobs->ok = false;
+#ifdef USE_THREADS
+      pthread_mutex_unlock (&jobs->lock);
+#endif
+    }
+  return NULL;
+}
+
+/* Run WORKER on LIMIT units of work from JOBS, on up to NTHREADS
+   threads.  */
+
+static void
+run_merge_jobs (struct merge_jobs *jobs, unsigned int limit,
+		void *(*worker) (void *), unsigned int nthreads)
+{
+  jobs->next = 0;
+  jobs->limit = limit;
+  if (nthreads > limit)
+    nthreads = limit;
+  if (nthreads > merge_stats.threads)
+    merge_stats.threads = nthreads;
+#ifdef USE_THREADS
+  {
+    unsigned int i;
+    pthread_t *threads = NULL;
+
+    /* Not counting this thread.  */
+    if (nthreads > 1)
+      threads = (pthread_t *) bfd_malloc ((nthreads - 1) * sizeof (*threads));
+    if (threads == NULL)
+      nthreads = 1;
+
+    pthread_mutex_init (&jobs->lock, NULL);
+    for (i = 0; i + 1 < nthreads; i++)
+      if (pthread_create (&threads[i], NULL, worker, jobs) != 0)
+	break;
+    nthreads = i;
+
+    /* This thread does its share of the work too, and all of it if no
+       threads could be started.  */
+    worker (jobs);
+
+    for (i = 0; i < nthreads; i++)
+      pthread_join (threads[i], NULL);
+    pthread_mutex_destroy (&jobs->lock);
+    free (threads);
+  }
+#else
+  worker (jobs);
+#endif
+}
+
+/* Enter the blobs of JOBS into their hash table, and finish the offset
+   maps of their sections.  Return FALSE on error.  */
+
+static bool
+enter_sections (struct merge_jobs *jobs, unsigned int nthreads)
+{
+  struct sec_merge_hash *htab = jobs->htab;
+  unsigned int j, i;
+  uint64_t start;
+
+  start = merge_clock ();
+  run_merge_jobs (jobs, jobs->count, hash_sections_worker, nthreads);
+  for (j = 0; j < jobs->count; j++)
+    if (!jobs->jobs[j].ok)
+      {
+	bfd_set_error (bfd_error_no_memory);
+	return false;
+      }
+  merge_stats.hash_time += merge_clock () - start;
+
+  start = merge_clock ();
+  jobs->ok = true;
+  run_merge_jobs (jobs, htab->nshards > 1 ? htab->nshards : 1,
+		  enter_shards_worker, nthreads);
+  if (!jobs->ok)
+    {
+      bfd_set_error (bfd_error_no_memory);
+      return false;
     }
 
-  /* Add a sentinel element that's conceptually behind all others.  */
-  append_offsetmap (secinfo, sec->size, NULL);
-  /* But don't count it.  */
-  secinfo->noffsetmap--;
-
-  free (contents);
-  contents = NULL;
-
-  /* We allocate the ofsmap arrays in blocks of 2048 elements.
-     In case we have very many small input files/sections,
-     this might waste large amounts of memory, so reallocate these
-     arrays here to their true size.  */
-  amt = secinfo->noffsetmap + 1;
-  tmpptr = bfd_realloc (secinfo->map, amt * sizeof(secinfo->map[0]));
-  if (tmpptr)
-    secinfo->map = tmpptr;
-  tmpptr = bfd_realloc (secinfo->map_ofs, amt * sizeof(secinfo->map_ofs[0]));
-  if (tmpptr)
-    secinfo->map_ofs = tmpptr;
-
-  /*printf ("ZZZ %s:%s %u entries\n", sec->owner->filename, sec->name,
-	  (unsigned)secinfo->noffsetmap);*/
+  /* Chain up the new entries in the order they were first seen, which
+     doesn't depend on how many threads there were.  An entry is not
+     chained yet if it is not the last and has no next.  */
+  for (j = 0; j < jobs->count; j++)
+    {
+      struct sec_merge_sec_info *secinfo = jobs->jobs[j].secinfo;
+      void *tmpptr;
+      bfd_size_type amt;
+
+      merge_stats.blobs += secinfo->noffsetmap;
+      for (i = 0; i < secinfo->noffsetmap; i++)
+	{
+	  struct sec_merge_hash_entry *entry = secinfo->map[i].entry;
 
+	  if (entry->next == NULL && entry != htab->last)
+	    {
+	      if (htab->first == NULL)
+		htab->first = entry;
+	      else
+		htab->last->next = entry;
+	      htab->last = entry;
+	      htab->size++;
+	    }
+	}
+
+      /* Add a sentinel element that's conceptually behind all others.  */
+      if (! append_offsetmap (secinfo, secinfo->sec->size, NULL))
+	return false;
+      /* But don't count it.  */
+      secinfo->noffsetmap--;
+
+      /* We allocate the ofsmap arrays in blocks of 2048 elements.
+	 In case we have very many small input files/sections,
+	 this might waste large amounts of memory, so reallocate these
+	 arrays here to their true size.  */
+      amt = secinfo->noffsetmap + 1;
+      tmpptr = bfd_realloc (secinfo->map, amt * sizeof(secinfo->map[0]));
+      if (tmpptr)
+	secinfo->map = tmpptr;
+      tmpptr = bfd_realloc (secinfo->map_ofs,
+			    amt * sizeof(secinfo->map_ofs[0]));
+      if (tmpptr)
+	secinfo->map_ofs = tmpptr;
+    }
+  merge_stats.insert_time += merge_clock () - start;
   return true;
+}
 
- error_return:
-  free (contents);
-  contents = NULL;
-  for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
-    *secinfo->psecinfo = NULL;
-  return false;
+/* Record all input sections of SINFO that are not excluded into its
+   hash table, on up to NTHREADS threads.  The sections are read in
+   batches, and each batch is first scanned for blobs and then entered
+   into the hash table.  The hash table ends up the same for any number
+   of threads.  */
+
+static bool
+record_sections (struct sec_merge_info *sinfo, unsigned int nthreads)
+{
+  struct sec_merge_sec_info *secinfo;
+  struct merge_jobs jobs;
+  bfd_size_type batch_size, size;
+  unsigned int alloc, j;
+  uint64_t start;
+  bool ret = true;
+
+  memset (&jobs, 0, sizeof (jobs));
+  jobs.htab = sinfo->htab;
+  batch_size = nthreads > 1 ? MERGE_BATCH_SIZE : 0;
+  alloc = 0;
+  size = 0;
+  for (secinfo = sinfo->chain; ret && secinfo; secinfo = secinfo->next)
+    {
+      asection *sec = secinfo->sec;
+      struct merge_job *job;
+      bfd_size_type amt;
+
+      if (sec->flags & SEC_EXCLUDE)
+	continue;
+
+      start = merge_clock ();
+      if (jobs.count == alloc)
+	{
+	  alloc = alloc ? alloc * 2 : 64;
+	  job = bfd_realloc (jobs.jobs, alloc * sizeof (*job));
+	  if (job == NULL)
+	    {
+	      ret = false;
+	      break;
+	    }
+	  jobs.jobs = job;
+	}
+      job = &jobs.jobs[jobs.count++];
+      memset (job, 0, sizeof (*job));
+      job->secinfo = secinfo;
+
+      amt = sec->size;
+      if (sec->flags & SEC_STRINGS)
+	/* Some versions of gcc may emit a string without a zero terminator.
+	   See http://gcc.gnu.org/ml/gcc-patches/2006-06/msg01004.html
+	   Allocate space for an extra zero.  */
+	amt += sec->entsize;
+      job->contents = bfd_malloc (amt);
+      if (!job->contents)
+	{
+	  ret = false;
+	  break;
+	}
+
+      /* Slurp in all section contents (possibly decompressing it).  */
+      sec->rawsize = sec->size;
+      if (sec->flags & SEC_STRINGS)
+	memset (job->contents + sec->size, 0, sec->entsize);
+      if (! bfd_get_full_section_contents (sec->owner, sec, &job->contents))
+	{
+	  ret = false;
+	  break;
+	}
+      merge_stats.sections++;
+      merge_stats.input_bytes += sec->size;
+      merge_stats.read_time += merge_clock () - start;
+
+      size += sec->size;
+      if (size >= batch_size)
+	{
+	  ret = enter_sections (&jobs, nthreads);
+	  for (j = 0; j < jobs.count; j++)
+	    {
+	      free (jobs.jobs[j].contents);
+	      free (jobs.jobs[j].hash_lens);
+	      free (jobs.jobs[j].shard_blobs);
+	    }
+	  jobs.count = 0;
+	  size = 0;
+	}
+    }
+
+  if (ret && jobs.count != 0)
+    ret = enter_sections (&jobs, nthreads);
+  for (j = 0; j < jobs.count; j++)
+    {
+      free (jobs.jobs[j].contents);
+      free (jobs.jobs[j].hash_lens);
+      free (jobs.jobs[j].shard_blobs);
+    }
+  free (jobs.jobs);
+
+  if (!ret)
+    for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
+      *secinfo->psecinfo = NULL;
+  return ret;
 }
 
 /* qsort comparison function.  Won't ever return zero as all entries
@@ -966,22 +1327,40 @@ merge_strings (struct sec_merge_info *sinfo)
 
 bool
 _bfd_merge_sections (bfd *abfd,
-		     struct bfd_link_info *info ATTRIBUTE_UNUSED,
+		     struct bfd_link_info *info,
 		     void *xsinfo,
 		     void (*remove_hook) (bfd *, asection *))
 {
   struct sec_merge_info *sinfo;
+  unsigned int nthreads = 1;
+
+#ifdef USE_THREADS
+  if (info != NULL && info->threads > 1)
+    {
+      long nproc = sysconf (_SC_NPROCESSORS_ONLN);
+
+      nthreads = info->threads;
+      if (nproc < 1)
+	nthreads = 1;
+      else if ((unsigned long) nproc < nthreads)
+	nthreads = nproc;
+    }
+#else
+  (void) info;
+#endif
 
   for (sinfo = (struct sec_merge_info *) xsinfo; sinfo; sinfo = sinfo->next)
     {
       struct sec_merge_sec_info *secinfo;
       bfd_size_type align;  /* Bytes.  */
+      bfd_size_type total;
+      uint64_t start;
 
       if (! sinfo->chain)
 	continue;
 
-      /* Record the sections into the hash table.  */
       align = 1;
+      total = 0;
       for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
 	if (secinfo->sec->flags & SEC_EXCLUDE)
 	  {
@@ -991,8 +1370,7 @@ _bfd_merge_sections (bfd *abfd,
 	  }
 	else
 	  {
-	    if (!record_section (sinfo, secinfo))
-	      return false;
+	    total += secinfo->sec->size;
 	    if (align)
 	      {
 		unsigned int opb = bfd_octets_per_byte (abfd, secinfo->sec);
@@ -1003,9 +1381,41 @@ _bfd_merge_sections (bfd *abfd,
 	      }
 	  }
 
+      /* Split the hash table if the sections are to be entered on
+	 several threads.  */
+      if (nthreads > 1
+	  && total >= MERGE_THREADS_MIN_SIZE
+	  && sinfo->htab->nshards == 1)
+	{
+	  struct sec_merge_hash *htab = sinfo->htab;
+	  unsigned int i, nshards = 1u << MERGE_SHARD_BITS;
+
+	  htab->shards = (struct sec_merge_hash **)
+	    bfd_zmalloc (nshards * sizeof (*htab->shards));
+	  if (htab->shards == NULL)
+	    return false;
+	  htab->nshards = nshards;
+	  htab->shards[0] = htab;
+	  for (i = 1; i < nshards; i++)
+	    {
+	      htab->shards[i] = sec_merge_init (htab->entsize, htab->strings);
+	      if (htab->shards[i] == NULL)
+		return false;
+	    }
+	}
+
+      /* Record the sections into the hash table.  Sections too small to
+	 be worth splitting the table for are recorded on this thread.  */
+      if (!record_sections (sinfo,
+			    total >= MERGE_THREADS_MIN_SIZE ? nthreads : 1))
+	return false;
+      merge_stats.unique += sinfo->htab->size;
+
       if (sinfo->htab->first == NULL)
 	continue;
 
+      start = merge_clock ();
+
       if (sinfo->htab->strings)
 	{
 	  secinfo = merge_strings (sinfo);
@@ -1045,6 +1455,9 @@ _bfd_merge_sections (bfd *abfd,
       for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
 	if (secinfo->first_str == NULL)
 	  secinfo->sec->flags |= SEC_EXCLUDE | SEC_KEEP;
+	else
+	  merge_stats.output_bytes += secinfo->sec->size;
+      merge_stats.layout_time += merge_clock () - start;
     }
 
   return true;
@@ -1143,6 +1556,21 @@ _bfd_merged_section_offset (bfd *output_bfd ATTRIBUTE_UNUSED, asection **psec,
   return MAP_IDX(secinfo, lb) + offset - MAP_OFS(secinfo, lb);
 }
 
+/* Build the map used by _bfd_merged_section_offset to look up offsets
+   in the SEC_MERGE section described by PSECINFO, which is otherwise
+   built on first use.  Once it is built, _bfd_merged_section_offset
+   changes nothing and so may be called from several threads.  */
+
+void
+_bfd_merged_section_prepare (void *psecinfo)
+{
+  struct sec_merge_sec_info *secinfo;
+
+  secinfo = (struct sec_merge_sec_info *) psecinfo;
+  if (secinfo != NULL && !secinfo->fast_state)
+    prepare_offsetmap (secinfo);
+}
+
 /* Tidy up when done.  */
 
 void
@@ -1153,13 +1581,29 @@ _bfd_merge_sections_free (void *xsinfo)
   for (sinfo = (struct sec_merge_info *) xsinfo; sinfo; sinfo = sinfo->next)
     {
       struct sec_merge_sec_info *secinfo;
+      unsigned int i;
+
       for (secinfo = sinfo->chain; secinfo; secinfo = secinfo->next)
 	{
 	  free (secinfo->ofstolowbound);
 	  free (secinfo->map);
 	  free (secinfo->map_ofs);
 	}
+      for (i = 1; i < sinfo->htab->nshards; i++)
+	{
+	  bfd_hash_table_free (&sinfo->htab->shards[i]->table);
+	  free (sinfo->htab->shards[i]);
+	}
+      free (sinfo->htab->shards);
       bfd_hash_table_free (&sinfo->htab->table);
       free (sinfo->htab);
     }
 }
+
+/* Fill in STATS with the counts and timings of merging so far.  */
+
+void
+_bfd_merge_get_stats (struct bfd_merge_stats *stats)
+{
+  *stats = merge_stats;
+}
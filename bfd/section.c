@@ -133,6 +133,9 @@ SUBSECTION
 #include "bfd.h"
 #include "libbfd.h"
 #include "bfdlink.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 /*
 DOCDD
@@ -1628,6 +1631,69 @@ bfd_malloc_and_get_section (bfd *abfd, sec_ptr sec, bfd_byte **buf)
   *buf = NULL;
   return bfd_get_full_section_contents (abfd, sec, buf);
 }
+
+/*
+FUNCTION
+	bfd_map_section_contents
+
+SYNOPSIS
+	bfd_byte *bfd_map_section_contents
+	  (bfd *abfd, asection *section, void **map_addr,
+	   bfd_size_type *map_len);
+
+DESCRIPTION
+	Return a read-only mapping of all the data in @var{section}
+	of BFD @var{abfd}, if the data is stored in the file just as
+	bfd_get_section_contents would return it.  Otherwise, for
+	example if the section is compressed, held in memory or read
+	through a target specific method, return NULL.  The page
+	aligned address and length of the mapping, to be passed to
+	munmap, are written to @var{map_addr} and @var{map_len}.  If
+	@var{map_addr} is set to NULL, the contents are part of a
+	mapping kept by the file cache, and must not be unmapped.
+*/
+
+bfd_byte *
+bfd_map_section_contents (bfd *abfd ATTRIBUTE_UNUSED,
+			  sec_ptr section ATTRIBUTE_UNUSED,
+			  void **map_addr ATTRIBUTE_UNUSED,
+			  bfd_size_type *map_len ATTRIBUTE_UNUSED)
+{
+#ifdef HAVE_MMAP
+  bfd_size_type sz = bfd_get_section_limit_octets (abfd, section);
+  ufile_ptr filesize;
+  void *mem;
+
+  if (abfd->direction != read_direction
+      || (abfd->flags & BFD_IN_MEMORY) != 0
+      || ((section->flags & (SEC_HAS_CONTENTS | SEC_IN_MEMORY
+			     | SEC_CONSTRUCTOR))
+	  != SEC_HAS_CONTENTS)
+      || section->compress_status != COMPRESS_SECTION_NONE
+      || abfd->xvec->_bfd_get_section_contents
+	 != _bfd_generic_get_section_contents
+      || sz == 0
+      || sz != (size_t) sz)
+    return NULL;
+
+  /* Don't map anything beyond the end of the file (or archive
+     member), since touching it would fault.  */
+  filesize = bfd_get_file_size (abfd);
+  if (filesize == 0
+      || section->filepos < 0
+      || (ufile_ptr) section->filepos > filesize
+      || sz > filesize - section->filepos)
+    return NULL;
+
+  mem = bfd_mmap (abfd, NULL, sz, PROT_READ, MAP_PRIVATE, section->filepos,
+		  map_addr, map_len);
+  if (mem == MAP_FAILED)
+    return NULL;
+  return (bfd_byte *) mem;
+#else
+  return NULL;
+#endif
+}
 /*
 FUNCTION
 	bfd_copy_private_section_data
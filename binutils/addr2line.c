@@ -34,6 +34,7 @@
 #include "bfd.h"
 #include "getopt.h"
 #include "libiberty.h"
+#include "hashtab.h"
 #include "demangle.h"
 #include "bucomm.h"
 #include "elf-bfd.h"
@@ -55,6 +56,38 @@ static char **addr;		/* Hex addresses to process.  */
 static long symcount;
 static asymbol **syms;		/* Symbol table.  */
 
+/* An entry in the symbol name hash tables, used to look up the
+   symbols given in symbol+offset expressions.  */
+
+struct symbol_name_entry
+{
+  const char *name;
+  asymbol *sym;
+};
+
+static htab_t symbol_names;		/* Raw symbol names.  */
+static htab_t demangled_symbol_names;	/* Demangled symbol names.  */
+
+/* An allocated section and the range of addresses it covers.  These
+   are kept sorted by address, so that the sections which might hold
+   an address can be found without looking at every section.  */
+
+struct section_range
+{
+  bfd_vma vma;
+  bfd_vma end;
+  /* The highest END of this and all preceding ranges.  */
+  bfd_vma max_end;
+  /* The position of the section in the section list.  */
+  unsigned int order;
+  asection *section;
+};
+
+static struct section_range *section_ranges;
+static unsigned int section_range_count;
+/* Space for the ranges that contain an address.  */
+static struct section_range **section_candidates;
+
 static struct option long_options[] =
 {
   {"addresses", no_argument, NULL, 'a'},
@@ -79,6 +112,7 @@ static void usage (FILE *, int);
 static void slurp_symtab (bfd *);
 static void find_address_in_section (bfd *, asection *, void *);
 static void find_offset_in_section (bfd *, asection *);
+static void find_address_in_sections (bfd *);
 static void translate_addresses (bfd *, asection *);
 
 /* Print a usage message to STREAM and exit with STATUS.  */
@@ -173,8 +207,8 @@ static unsigned int line;
 static unsigned int discriminator;
 static bool found;
 
-/* Look for an address in a section.  This is called via
-   bfd_map_over_sections.  */
+/* Look for an address in a section.  This is called by
+   find_address_in_sections.  */
 
 static void
 find_address_in_section (bfd *abfd, asection *section,
@@ -224,29 +258,230 @@ find_offset_in_section (bfd *abfd, asection *section)
                                                &line, &discriminator);
 }
 
-/* Lookup a symbol with offset in symbol table.  */
+/* Add SECTION to section_ranges, if it is allocated and not empty.
+   This is called via bfd_map_over_sections.  */
 
-static bfd_vma
-lookup_symbol (bfd *abfd, char *sym, size_t offset)
+static void
+add_section_range (bfd *abfd ATTRIBUTE_UNUSED, asection *section,
+		   void *data)
 {
-  long i;
+  unsigned int *order = (unsigned int *) data;
+  struct section_range *range;
+  bfd_vma vma;
+  bfd_vma end;
 
-  for (i = 0; i < symcount; i++)
+  ++*order;
+  if ((bfd_section_flags (section) & SEC_ALLOC) == 0)
+    return;
+
+  vma = bfd_section_vma (section);
+  end = vma + bfd_section_size (section);
+  if (end <= vma)
+    return;
+
+  range = &section_ranges[section_range_count++];
+  range->vma = vma;
+  range->end = end;
+  range->order = *order;
+  range->section = section;
+}
+
+/* Sort section ranges by address, and then by section list order.  */
+
+static int
+compare_section_ranges (const void *a, const void *b)
+{
+  const struct section_range *ra = (const struct section_range *) a;
+  const struct section_range *rb = (const struct section_range *) b;
+
+  if (ra->vma != rb->vma)
+    return ra->vma < rb->vma ? -1 : 1;
+  return ra->order < rb->order ? -1 : ra->order > rb->order;
+}
+
+/* Sort section range pointers by section list order.  */
+
+static int
+compare_section_range_order (const void *a, const void *b)
+{
+  const struct section_range *ra = *(const struct section_range **) a;
+  const struct section_range *rb = *(const struct section_range **) b;
+
+  return ra->order < rb->order ? -1 : ra->order > rb->order;
+}
+
+/* Set up section_ranges for ABFD.  */
+
+static void
+build_section_ranges (bfd *abfd)
+{
+  unsigned int order = 0;
+  unsigned int i;
+  bfd_vma max_end = 0;
+
+  section_ranges = (struct section_range *)
+    xmalloc ((bfd_count_sections (abfd) + 1) * sizeof (*section_ranges));
+  section_range_count = 0;
+  bfd_map_over_sections (abfd, add_section_range, &order);
+  qsort (section_ranges, section_range_count, sizeof (*section_ranges),
+	 compare_section_ranges);
+  section_candidates = (struct section_range **)
+    xmalloc ((section_range_count + 1) * sizeof (*section_candidates));
+
+  for (i = 0; i < section_range_count; i++)
+    {
+      if (section_ranges[i].end > max_end)
+	max_end = section_ranges[i].end;
+      section_ranges[i].max_end = max_end;
+    }
+}
+
+/* Look for PC in the sections of ABFD.  The sections that contain it
+   are tried in the order of the section list, as bfd_map_over_sections
+   would.  */
+
+static void
+find_address_in_sections (bfd *abfd)
+{
+  struct section_range **candidates;
+  unsigned int ncandidates;
+  unsigned int lo, hi;
+  unsigned int i;
+
+  if (section_ranges == NULL)
+    build_section_ranges (abfd);
+
+  /* Find the first range that starts beyond PC.  */
+  lo = 0;
+  hi = section_range_count;
+  while (lo < hi)
     {
-      if (!strcmp (syms[i]->name, sym))
-	return syms[i]->value + offset + bfd_asymbol_section (syms[i])->vma;
+      unsigned int mid = lo + (hi - lo) / 2;
+
+      if (section_ranges[mid].vma <= pc)
+	lo = mid + 1;
+      else
+	hi = mid;
     }
-  /* Try again mangled */
+
+  /* Ranges overlap only in unusual files, such as relocatable objects,
+     so there is almost always at most one candidate.  */
+  candidates = section_candidates;
+  ncandidates = 0;
+  for (i = lo; i > 0 && section_ranges[i - 1].max_end > pc; i--)
+    if (section_ranges[i - 1].end > pc)
+      candidates[ncandidates++] = &section_ranges[i - 1];
+
+  if (ncandidates > 1)
+    qsort (candidates, ncandidates, sizeof (*candidates),
+	   compare_section_range_order);
+
+  for (i = 0; i < ncandidates && !found; i++)
+    find_address_in_section (abfd, candidates[i]->section, NULL);
+}
+
+static hashval_t
+hash_symbol_name_entry (const void *p)
+{
+  const struct symbol_name_entry *entry
+    = (const struct symbol_name_entry *) p;
+
+  return htab_hash_string (entry->name);
+}
+
+static int
+eq_symbol_name_entry (const void *a, const void *b)
+{
+  const struct symbol_name_entry *ea = (const struct symbol_name_entry *) a;
+  const struct symbol_name_entry *eb = (const struct symbol_name_entry *) b;
+
+  return strcmp (ea->name, eb->name) == 0;
+}
+
+static void
+del_demangled_symbol_name_entry (void *p)
+{
+  struct symbol_name_entry *entry = (struct symbol_name_entry *) p;
+
+  free ((char *) entry->name);
+  free (entry);
+}
+
+/* Return a hash table of the names of the symbols in syms, demangled
+   if DEMANGLED.  Each name maps to the first symbol which has it.  */
+
+static htab_t
+build_symbol_names (bfd *abfd, bool demangled)
+{
+  htab_t htab;
+  long i;
+
+  htab = htab_create_alloc (symcount, hash_symbol_name_entry,
+			    eq_symbol_name_entry,
+			    demangled ? del_demangled_symbol_name_entry : free,
+			    xcalloc, free);
+
   for (i = 0; i < symcount; i++)
     {
-      char *d = bfd_demangle (abfd, syms[i]->name, demangle_flags);
-      bool match = d && !strcmp (d, sym);
-      free (d);
+      struct symbol_name_entry key;
+      void **slot;
+      char *d = NULL;
+
+      if (demangled)
+	{
+	  d = bfd_demangle (abfd, syms[i]->name, demangle_flags);
+	  if (d == NULL)
+	    continue;
+	  key.name = d;
+	}
+      else
+	key.name = syms[i]->name;
+
+      slot = htab_find_slot (htab, &key, INSERT);
+      if (*slot == NULL)
+	{
+	  struct symbol_name_entry *entry
+	    = (struct symbol_name_entry *) xmalloc (sizeof (*entry));
 
-      if (match)
-	return syms[i]->value + offset + bfd_asymbol_section (syms[i])->vma;
+	  entry->name = key.name;
+	  entry->sym = syms[i];
+	  *slot = entry;
+	}
+      else
+	free (d);
     }
-  return 0;
+
+  return htab;
+}
+
+/* Lookup a symbol with offset in symbol table.  */
+
+static bfd_vma
+lookup_symbol (bfd *abfd, char *sym, size_t offset)
+{
+  struct symbol_name_entry key;
+  struct symbol_name_entry *entry;
+
+  if (symcount <= 0)
+    return 0;
+
+  if (symbol_names == NULL)
+    symbol_names = build_symbol_names (abfd, false);
+  key.name = sym;
+  entry = (struct symbol_name_entry *) htab_find (symbol_names, &key);
+  if (entry == NULL)
+    {
+      /* Try again mangled */
+      if (demangled_symbol_names == NULL)
+	demangled_symbol_names = build_symbol_names (abfd, true);
+      entry = (struct symbol_name_entry *) htab_find (demangled_symbol_names,
+						      &key);
+    }
+  if (entry == NULL)
+    return 0;
+
+  return (entry->sym->value + offset
+	  + bfd_asymbol_section (entry->sym)->vma);
 }
 
 /* Split an symbol+offset expression. adr is modified.  */
@@ -337,7 +572,7 @@ translate_addresses (bfd *abfd, asection *section)
       if (section)
 	find_offset_in_section (abfd, section);
       else
-	bfd_map_over_sections (abfd, find_address_in_section, NULL);
+	find_address_in_sections (abfd);
 
       if (! found)
 	{
@@ -483,6 +718,16 @@ process_file (const char *file_name, const char *section_name,
 
   free (syms);
   syms = NULL;
+  if (symbol_names != NULL)
+    htab_delete (symbol_names);
+  symbol_names = NULL;
+  if (demangled_symbol_names != NULL)
+    htab_delete (demangled_symbol_names);
+  demangled_symbol_names = NULL;
+  free (section_ranges);
+  section_ranges = NULL;
+  free (section_candidates);
+  section_candidates = NULL;
 
   bfd_close (abfd);
 
@@ -31,6 +31,7 @@
 #include "bucomm.h"
 #include "arsup.h"
 #include "filenames.h"
+#include "hashtab.h"
 #include "binemul.h"
 #include "plugin-api.h"
 #include "plugin.h"
@@ -1280,6 +1281,12 @@ write_archive (bfd *iarch)
   if (full_pathname)
     obfd->flags |= BFD_ARCHIVE_FULL_PATH;
 
+  /* Members which have not changed keep their entries in the symbol
+     map, rather than having their symbols read again.  Rebuild the
+     map from scratch when that is all we have been asked to do.  */
+  if (operation != none)
+    obfd->flags |= BFD_ARCHIVE_REUSE_MAP;
+
   if (make_thin_archive || bfd_is_thin_archive (iarch))
     bfd_set_thin_archive (obfd, true);
 
@@ -1456,6 +1463,95 @@ move_members (bfd *arch, char **files_to_move)
   write_archive (arch);
 }
 
+/* The members of an archive read from disk which have the same name,
+   as given by normalize, in archive order.  */
+
+struct member_name_entry
+{
+  const char *name;
+  bfd *member;
+  struct member_name_entry *next;
+};
+
+static hashval_t
+hash_member_name_entry (const void *p)
+{
+  const struct member_name_entry *entry
+    = (const struct member_name_entry *) p;
+
+  return filename_hash (entry->name);
+}
+
+static int
+eq_member_name_entry (const void *a, const void *b)
+{
+  const struct member_name_entry *ea = (const struct member_name_entry *) a;
+  const struct member_name_entry *eb = (const struct member_name_entry *) b;
+
+  return FILENAME_CMP (ea->name, eb->name) == 0;
+}
+
+static void
+del_member_name_entry (void *p)
+{
+  struct member_name_entry *entry = (struct member_name_entry *) p;
+
+  while (entry != NULL)
+    {
+      struct member_name_entry *next = entry->next;
+
+      free (entry);
+      entry = next;
+    }
+}
+
+/* Return a hash table of the members of ARCH by name, so that
+   replace_members need not compare each file to be added with every
+   member.  */
+
+static htab_t
+build_member_names (bfd *arch)
+{
+  htab_t htab;
+  bfd **members;
+  size_t count;
+  size_t i;
+  bfd *current;
+
+  count = 0;
+  for (current = arch->archive_next; current; current = current->archive_next)
+    count++;
+  members = (bfd **) xmalloc ((count + 1) * sizeof (*members));
+  count = 0;
+  for (current = arch->archive_next; current; current = current->archive_next)
+    members[count++] = current;
+
+  htab = htab_create_alloc (count, hash_member_name_entry,
+			    eq_member_name_entry, del_member_name_entry,
+			    xcalloc, free);
+
+  /* Add the members last first, so that each list is in archive
+     order.  */
+  for (i = count; i-- > 0; )
+    {
+      struct member_name_entry *entry;
+      void **slot;
+
+      if (members[i]->arelt_data == NULL)
+	continue;
+
+      entry = (struct member_name_entry *) xmalloc (sizeof (*entry));
+      entry->name = normalize (bfd_get_filename (members[i]), arch);
+      entry->member = members[i];
+      slot = htab_find_slot (htab, entry, INSERT);
+      entry->next = (struct member_name_entry *) *slot;
+      *slot = entry;
+    }
+
+  free (members);
+  return htab;
+}
+
 /* Ought to default to replacing in place, but this is existing practice!  */
 
 static void
@@ -1465,88 +1561,103 @@ replace_members (bfd *arch, char **files_to_move, bool quick)
   bfd **after_bfd;		/* New entries go after this one.  */
   bfd *current;
   bfd **current_ptr;
+  htab_t member_names = NULL;
 
   while (files_to_move && *files_to_move)
     {
       if (! quick)
 	{
-	  current_ptr = &arch->archive_next;
-	  while (*current_ptr)
+	  struct member_name_entry key, *entry;
+	  void **slot;
+
+	  if (member_names == NULL)
+	    member_names = build_member_names (arch);
+
+	  /* For compatibility with existing ar programs, we
+	     permit the same file to be added multiple times.  */
+	  key.name = normalize (*files_to_move, arch);
+	  slot = htab_find_slot (member_names, &key, NO_INSERT);
+	  entry = slot != NULL ? (struct member_name_entry *) *slot : NULL;
+	  if (entry != NULL)
 	    {
-	      current = *current_ptr;
+	      bool replaced;
 
-	      /* For compatibility with existing ar programs, we
-		 permit the same file to be added multiple times.  */
-	      if (FILENAME_CMP (normalize (*files_to_move, arch),
-				normalize (bfd_get_filename (current), arch)) == 0
-		  && current->arelt_data != NULL)
+	      current = entry->member;
+	      current_ptr = &arch->archive_next;
+	      while (*current_ptr != current)
+		current_ptr = &(*current_ptr)->archive_next;
+
+	      if (newer_only)
 		{
-		  bool replaced;
+		  struct stat fsbuf, asbuf;
 
-		  if (newer_only)
+		  if (stat (*files_to_move, &fsbuf) != 0)
 		    {
-		      struct stat fsbuf, asbuf;
-
-		      if (stat (*files_to_move, &fsbuf) != 0)
-			{
-			  if (errno != ENOENT)
-			    bfd_fatal (*files_to_move);
-			  goto next_file;
-			}
-
-		      if (bfd_stat_arch_elt (current, &asbuf) != 0)
-			/* xgettext:c-format */
-			fatal (_("internal stat error on %s"),
-			       bfd_get_filename (current));
-
-		      if (fsbuf.st_mtime <= asbuf.st_mtime)
-			/* A note about deterministic timestamps:  In an
-			   archive created in a determistic manner the
-			   individual elements will either have a timestamp
-			   of 0 or SOURCE_DATE_EPOCH, depending upon the
-			   method used.  This will be the value retrieved
-			   by bfd_stat_arch_elt().
-
-			   The timestamp in fsbuf.st_mtime however will
-			   definitely be greater than 0, and it is unlikely
-			   to be less than SOURCE_DATE_EPOCH.  (FIXME:
-			   should we test for this case case and issue an
-			   error message ?)
-
-			   So in either case fsbuf.st_mtime > asbuf.st_time
-			   and hence the incoming file will replace the
-			   current file.  Which is what should be expected to
-			   happen.  Deterministic archives have no real sense
-			   of the time/date when their elements were created,
-			   and so any updates to the archive should always
-			   result in replaced files.  */
-			goto next_file;
+		      if (errno != ENOENT)
+			bfd_fatal (*files_to_move);
+		      goto next_file;
 		    }
 
-		  after_bfd = get_pos_bfd (&arch->archive_next, pos_after,
-					   bfd_get_filename (current));
-		  if (libdeps_bfd != NULL
-		      && FILENAME_CMP (normalize (*files_to_move, arch),
-				       LIBDEPS) == 0)
+		  if (bfd_stat_arch_elt (current, &asbuf) != 0)
+		    /* xgettext:c-format */
+		    fatal (_("internal stat error on %s"),
+			   bfd_get_filename (current));
+
+		  if (fsbuf.st_mtime <= asbuf.st_mtime)
+		    /* A note about deterministic timestamps:  In an
+		       archive created in a determistic manner the
+		       individual elements will either have a timestamp
+		       of 0 or SOURCE_DATE_EPOCH, depending upon the
+		       method used.  This will be the value retrieved
+		       by bfd_stat_arch_elt().
+
+		       The timestamp in fsbuf.st_mtime however will
+		       definitely be greater than 0, and it is unlikely
+		       to be less than SOURCE_DATE_EPOCH.  (FIXME:
+		       should we test for this case case and issue an
+		       error message ?)
+
+		       So in either case fsbuf.st_mtime > asbuf.st_time
+		       and hence the incoming file will replace the
+		       current file.  Which is what should be expected to
+		       happen.  Deterministic archives have no real sense
+		       of the time/date when their elements were created,
+		       and so any updates to the archive should always
+		       result in replaced files.  */
+		    goto next_file;
+		}
+
+	      after_bfd = get_pos_bfd (&arch->archive_next, pos_after,
+				       bfd_get_filename (current));
+	      if (libdeps_bfd != NULL
+		  && FILENAME_CMP (normalize (*files_to_move, arch),
+				   LIBDEPS) == 0)
+		{
+		  replaced = ar_emul_replace_bfd (after_bfd, libdeps_bfd,
+						  verbose);
+		}
+	      else
+		{
+		  replaced = ar_emul_replace (after_bfd, *files_to_move,
+					      target, verbose);
+		}
+	      if (replaced)
+		{
+		  /* Snip out this entry from the chain.  */
+		  *current_ptr = (*current_ptr)->archive_next;
+		  changed = true;
+
+		  /* And from the name table.  */
+		  if (entry->next != NULL)
 		    {
-		      replaced = ar_emul_replace_bfd (after_bfd, libdeps_bfd,
-						      verbose);
+		      *slot = entry->next;
+		      free (entry);
 		    }
 		  else
-		    {
-		      replaced = ar_emul_replace (after_bfd, *files_to_move,
-						  target, verbose);
-		    }
-		  if (replaced)
-		    {
-		      /* Snip out this entry from the chain.  */
-		      *current_ptr = (*current_ptr)->archive_next;
-		      changed = true;
-		    }
-
-		  goto next_file;
+		    htab_clear_slot (member_names, slot);
 		}
-	      current_ptr = &(current->archive_next);
+
+	      goto next_file;
 	    }
 	}
 
@@ -1570,6 +1681,9 @@ replace_members (bfd *arch, char **files_to_move, bool quick)
       files_to_move++;
     }
 
+  if (member_names != NULL)
+    htab_delete (member_names);
+
   if (changed)
     write_archive (arch);
   else
@@ -860,24 +860,11 @@ static asymbol *sort_y;
 /* Symbol-sorting predicates */
 #define valueof(x) ((x)->section->vma + (x)->value)
 
-/* Numeric sorts.  Undefined symbols are always considered "less than"
-   defined symbols with zero values.  Common symbols are not treated
-   specially -- i.e., their sizes are used as their "values".  */
+/* Compare the symbol names XN and YN.  */
 
 static int
-non_numeric_forward (const void *P_x, const void *P_y)
+compare_symbol_names (const char *xn, const char *yn)
 {
-  asymbol *x, *y;
-  const char *xn, *yn;
-
-  x = bfd_minisymbol_to_symbol (sort_bfd, sort_dynamic, P_x, sort_x);
-  y = bfd_minisymbol_to_symbol (sort_bfd, sort_dynamic, P_y, sort_y);
-  if (x == NULL || y == NULL)
-    bfd_fatal (bfd_get_filename (sort_bfd));
-
-  xn = bfd_asymbol_name (x);
-  yn = bfd_asymbol_name (y);
-
   if (yn == NULL)
     return xn != NULL;
   if (xn == NULL)
@@ -893,61 +880,207 @@ non_numeric_forward (const void *P_x, const void *P_y)
   return strcoll (xn, yn);
 }
 
+static int
+non_numeric_forward (const void *P_x, const void *P_y)
+{
+  asymbol *x, *y;
+
+  x = bfd_minisymbol_to_symbol (sort_bfd, sort_dynamic, P_x, sort_x);
+  y = bfd_minisymbol_to_symbol (sort_bfd, sort_dynamic, P_y, sort_y);
+  if (x == NULL || y == NULL)
+    bfd_fatal (bfd_get_filename (sort_bfd));
+
+  return compare_symbol_names (bfd_asymbol_name (x), bfd_asymbol_name (y));
+}
+
 static int
 non_numeric_reverse (const void *x, const void *y)
 {
   return - non_numeric_forward (x, y);
 }
 
+/* The sort key of a symbol.  The keys are computed once, so that the
+   comparisons do not have to convert minisymbols to symbols.  */
+
+struct sort_key
+{
+  /* The value of the symbol, or zero if it is undefined.  */
+  bfd_vma value;
+  const char *name;
+  /* The position of the minisymbol in the unsorted array.  */
+  long index;
+  bool undefined;
+};
+
+/* Compare the names of two sort keys, in the order given by
+   reverse_sort.  Symbols with the same name stay in their original
+   order.  */
+
 static int
-numeric_forward (const void *P_x, const void *P_y)
+compare_sort_key_names (const void *P_x, const void *P_y)
 {
-  asymbol *x, *y;
-  asection *xs, *ys;
+  const struct sort_key *x = *(const struct sort_key **) P_x;
+  const struct sort_key *y = *(const struct sort_key **) P_y;
+  int ret;
+
+  ret = compare_symbol_names (x->name, y->name);
+  if (reverse_sort)
+    ret = -ret;
+  if (ret == 0 && x->index != y->index)
+    ret = x->index < y->index ? -1 : 1;
+  return ret;
+}
 
-  x = bfd_minisymbol_to_symbol (sort_bfd, sort_dynamic, P_x, sort_x);
-  y =  bfd_minisymbol_to_symbol (sort_bfd, sort_dynamic, P_y, sort_y);
-  if (x == NULL || y == NULL)
-    bfd_fatal (bfd_get_filename (sort_bfd));
+/* Stably sort the COUNT keys pointed to by KEYS by value, in the order
+   given by reverse_sort, using TMP as scratch space.  This is a radix
+   sort on each byte of the value, skipping the bytes which are the
+   same in every key.  */
 
-  xs = bfd_asymbol_section (x);
-  ys = bfd_asymbol_section (y);
+static void
+radix_sort_keys (struct sort_key **keys, struct sort_key **tmp, long count)
+{
+  struct sort_key **from = keys;
+  struct sort_key **to = tmp;
+  unsigned int shift;
 
-  if (bfd_is_und_section (xs))
+  if (count < 2)
+    return;
+
+  for (shift = 0; shift < sizeof (bfd_vma) * 8; shift += 8)
     {
-      if (! bfd_is_und_section (ys))
-	return -1;
+      long counts[256];
+      long pos;
+      long i;
+      int b;
+
+      memset (counts, 0, sizeof counts);
+      for (i = 0; i < count; i++)
+	counts[(from[i]->value >> shift) & 0xff]++;
+      if (counts[(from[0]->value >> shift) & 0xff] == count)
+	continue;
+
+      pos = 0;
+      for (b = 0; b < 256; b++)
+	{
+	  int bucket = reverse_sort ? 255 - b : b;
+	  long n = counts[bucket];
+
+	  counts[bucket] = pos;
+	  pos += n;
+	}
+      for (i = 0; i < count; i++)
+	to[counts[(from[i]->value >> shift) & 0xff]++] = from[i];
+
+      from = to;
+      to = from == keys ? tmp : keys;
     }
-  else if (bfd_is_und_section (ys))
-    return 1;
-  else if (valueof (x) != valueof (y))
-    return valueof (x) < valueof (y) ? -1 : 1;
 
-  return non_numeric_forward (P_x, P_y);
+  if (from != keys)
+    memcpy (keys, from, count * sizeof (*keys));
 }
 
-static int
-numeric_reverse (const void *x, const void *y)
-{
-  return - numeric_forward (x, y);
-}
+/* Sort the SYMCOUNT minisymbols of SIZE bytes each in MINISYMS, by
+   name or, if sort_numerically, by value and then name.  For numeric
+   sorts, undefined symbols are always considered "less than" defined
+   symbols with zero values.  Common symbols are not treated specially
+   -- i.e., their sizes are used as their "values".  */
 
-static int (*(sorters[2][2])) (const void *, const void *) =
+static void
+sort_minisyms (bfd *abfd, bool is_dynamic, void *minisyms, long symcount,
+	       unsigned int size)
 {
-  { non_numeric_forward, non_numeric_reverse },
-  { numeric_forward, numeric_reverse }
-};
+  struct sort_key *keys;
+  struct sort_key **order;
+  bfd_byte *sorted;
+  long i;
+
+  if (symcount < 2)
+    return;
+
+  keys = (struct sort_key *) xmalloc (symcount * sizeof (*keys));
+  order = (struct sort_key **) xmalloc (symcount * sizeof (*order));
+  for (i = 0; i < symcount; i++)
+    {
+      asymbol *sym;
+
+      sym = bfd_minisymbol_to_symbol (abfd, is_dynamic,
+				      (bfd_byte *) minisyms + i * size,
+				      sort_x);
+      if (sym == NULL)
+	bfd_fatal (bfd_get_filename (abfd));
+
+      keys[i].name = bfd_asymbol_name (sym);
+      keys[i].undefined = bfd_is_und_section (bfd_asymbol_section (sym));
+      keys[i].value = keys[i].undefined ? 0 : valueof (sym);
+      keys[i].index = i;
+      order[i] = &keys[i];
+    }
+
+  if (!sort_numerically)
+    qsort (order, symcount, sizeof (*order), compare_sort_key_names);
+  else
+    {
+      struct sort_key **tmp;
+      long nundefined;
+      long j;
+
+      tmp = (struct sort_key **) xmalloc (symcount * sizeof (*tmp));
+
+      /* Put the undefined symbols first, or last for a reverse sort,
+	 and sort the defined symbols by value.  */
+      nundefined = 0;
+      j = 0;
+      for (i = 0; i < symcount; i++)
+	if (keys[i].undefined)
+	  tmp[nundefined++] = &keys[i];
+	else
+	  order[j++] = &keys[i];
+      radix_sort_keys (order, tmp + nundefined, j);
+      if (nundefined != 0)
+	{
+	  if (reverse_sort)
+	    memcpy (order + j, tmp, nundefined * sizeof (*order));
+	  else
+	    {
+	      memmove (order + nundefined, order, j * sizeof (*order));
+	      memcpy (order, tmp, nundefined * sizeof (*order));
+	    }
+	}
+      free (tmp);
+
+      /* Then sort the symbols with the same value by name.  */
+      for (i = 0; i < symcount; i = j)
+	{
+	  for (j = i + 1; j < symcount; j++)
+	    if (order[j]->undefined != order[i]->undefined
+		|| order[j]->value != order[i]->value)
+	      break;
+	  if (j - i > 1)
+	    qsort (order + i, j - i, sizeof (*order),
+		   compare_sort_key_names);
+	}
+    }
+
+  sorted = (bfd_byte *) xmalloc (symcount * size);
+  for (i = 0; i < symcount; i++)
+    memcpy (sorted + i * size,
+	    (bfd_byte *) minisyms + order[i]->index * size, size);
+  memcpy (minisyms, sorted, symcount * size);
+  free (sorted);
+  free (order);
+  free (keys);
+}
 
 /* This sort routine is used by sort_symbols_by_size.  It is similar
-   to numeric_forward, but when symbols have the same value it sorts
-   by section VMA.  This simplifies the sort_symbols_by_size code
-   which handles symbols at the end of sections.  Also, this routine
-   tries to sort file names before other symbols with the same value.
-   That will make the file name have a zero size, which will make
-   sort_symbols_by_size choose the non file name symbol, leading to
-   more meaningful output.  For similar reasons, this code sorts
-   gnu_compiled_* and gcc2_compiled before other symbols with the same
-   value.  */
+   to the numeric sort done by sort_minisyms, but when symbols have
+   the same value it sorts by section VMA.  This simplifies the
+   sort_symbols_by_size code which handles symbols at the end of
+   sections.  Also, this routine tries to sort file names before
+   other symbols with the same value.  That will make the file name
+   have a zero size, which will make sort_symbols_by_size choose the
+   non file name symbol, leading to more meaningful output.  For
+   similar reasons, this code sorts gnu_compiled_* and gcc2_compiled
+   before other symbols with the same value.  */
 
 static int
 size_forward1 (const void *P_x, const void *P_y)
@@ -1030,8 +1163,10 @@ size_forward2 (const void *P_x, const void *P_y)
     return reverse_sort ? 1 : -1;
   else if (x->size > y->size)
     return reverse_sort ? -1 : 1;
+  else if (reverse_sort)
+    return non_numeric_reverse (x->minisym, y->minisym);
   else
-    return sorters[0][reverse_sort] (x->minisym, y->minisym);
+    return non_numeric_forward (x->minisym, y->minisym);
 }
 
 /* Sort the symbols by size.  ELF provides a size but for other formats
@@ -1492,8 +1627,7 @@ display_rel_file (bfd *abfd, bfd *archive_bfd)
 	bfd_fatal (bfd_get_filename (abfd));
 
       if (! sort_by_size)
-	qsort (minisyms, symcount, size,
-	       sorters[sort_numerically][reverse_sort]);
+	sort_minisyms (abfd, dynamic, minisyms, symcount, size);
       else
 	symcount = sort_symbols_by_size (abfd, dynamic, minisyms, symcount,
 					 size, &symsizes);
@@ -36,6 +36,10 @@
 #include "coff/i386.h"
 #include "coff/pe.h"
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 static bfd_vma pe_file_alignment = (bfd_vma) -1;
 static bfd_vma pe_heap_commit = (bfd_vma) -1;
 static bfd_vma pe_heap_reserve = (bfd_vma) -1;
@@ -4477,6 +4481,49 @@ copy_relocations_in_section (bfd *ibfd, sec_ptr isection, void *obfdarg)
     }
 }
 
+#ifdef HAVE_MMAP
+/* Copy the SIZE bytes of ISECTION of IBFD to OSECTION of OBFD straight
+   from a mapping of the input file, if they are copied unchanged.
+   Return FALSE if the section needs to be read and copied the usual
+   way instead.  */
+
+static bool
+copy_section_from_map (bfd *ibfd, sec_ptr isection, bfd *obfd,
+		       sec_ptr osection, bfd_size_type size)
+{
+  bfd_byte *contents;
+  void *map_addr;
+  bfd_size_type map_len;
+
+  if (reverse_bytes || copy_byte >= 0)
+    return false;
+
+  /* bfd_convert_section_contents rewrites some sections when the ELF
+     class changes.  */
+  if (bfd_get_flavour (ibfd) == bfd_target_elf_flavour
+      && bfd_get_flavour (obfd) == bfd_target_elf_flavour
+      && (get_elf_backend_data (ibfd)->s->elfclass
+	  != get_elf_backend_data (obfd)->s->elfclass))
+    return false;
+
+  if (bfd_get_section_limit_octets (ibfd, isection) != size)
+    return false;
+
+  contents = bfd_map_section_contents (ibfd, isection, &map_addr, &map_len);
+  if (contents == NULL)
+    return false;
+
+  if (!bfd_set_section_contents (obfd, osection, contents, 0, size))
+    {
+      status = 1;
+      bfd_nonfatal_message (NULL, obfd, osection, NULL);
+    }
+  if (map_addr != NULL)
+    munmap (map_addr, map_len);
+  return true;
+}
+#endif
+
 /* Copy the data of input section ISECTION of IBFD
    to an output section with the same name in OBFD.  */
 
@@ -4503,6 +4550,11 @@ copy_section (bfd *ibfd, sec_ptr isection, void *obfdarg)
     {
       bfd_byte *memhunk = NULL;
 
+#ifdef HAVE_MMAP
+      if (copy_section_from_map (ibfd, isection, obfd, osection, size))
+	return;
+#endif
+
       if (!bfd_get_full_section_contents (ibfd, isection, &memhunk)
 	  || !bfd_convert_section_contents (ibfd, isection, obfd,
 					    &memhunk, &size))
@@ -72,6 +72,10 @@
 #include <sys/mman.h>
 #endif
 
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+
 #ifdef HAVE_LIBDEBUGINFOD
 #include <elfutils/debuginfod.h>
 #endif
@@ -138,6 +142,10 @@ static bool extended_color_output = false; /* --visualize-jumps=extended-color.
 static int process_links = false;       /* --process-links.  */
 static int show_all_symbols;            /* --show-all-symbols.  */
 static bool decompressed_dumps = false; /* -Z, --decompress.  */
+static int disassemble_jobs = 1;	/* --jobs.  */
+
+/* Each --jobs job is a process writing to a temporary file.  */
+#define MAX_DISASSEMBLE_JOBS 256
 
 static enum color_selection
   {
@@ -404,6 +412,8 @@ usage (FILE *stream, int status)
       fprintf (stream, _("\
       --show-all-symbols         When disassembling, display all symbols at a given address\n"));
       fprintf (stream, _("\
+      --jobs=N                   Disassemble using N parallel processes\n"));
+      fprintf (stream, _("\
       --special-syms             Include special symbols in symbol dumps\n"));
       fprintf (stream, _("\
       --inlines                  Print all inlines for source line (with -l)\n"));
@@ -488,7 +498,8 @@ enum option_values
 #endif
     OPTION_SFRAME,
     OPTION_VISUALIZE_JUMPS,
-    OPTION_DISASSEMBLER_COLOR
+    OPTION_DISASSEMBLER_COLOR,
+    OPTION_JOBS
   };
 
 static struct option long_options[]=
@@ -526,6 +537,7 @@ static struct option long_options[]=
   {"info", no_argument, NULL, 'i'},
   {"inlines", no_argument, 0, OPTION_INLINES},
   {"insn-width", required_argument, NULL, OPTION_INSN_WIDTH},
+  {"jobs", required_argument, NULL, OPTION_JOBS},
   {"line-numbers", no_argument, NULL, 'l'},
   {"no-addresses", no_argument, &no_addresses, 1},
   {"no-recurse-limit", no_argument, NULL, OPTION_NO_RECURSE_LIMIT},
@@ -2338,7 +2350,8 @@ show_line (bfd *abfd, asection *section, bfd_vma addr_offset)
     free (path);
 }
 
-/* Pseudo FILE object for strings.  */
+/* Pseudo FILE object for strings.  The buffer is always kept NUL
+   terminated.  */
 typedef struct
 {
   char *buffer;
@@ -2346,21 +2359,147 @@ typedef struct
   size_t alloc;
 } SFILE;
 
-/* sprintf to a "stream".  */
+/* Make room for N more characters plus a terminating NUL in F.  */
 
-static int ATTRIBUTE_PRINTF_2
-objdump_sprintf (SFILE *f, const char *format, ...)
+static inline void
+sfile_reserve (SFILE *f, size_t n)
+{
+  if (f->alloc - f->pos <= n)
+    {
+      f->alloc = (f->alloc + n) * 2;
+      f->buffer = (char *) xrealloc (f->buffer, f->alloc);
+    }
+}
+
+/* Append the LEN characters at S to F.  */
+
+static inline void
+sfile_append (SFILE *f, const char *s, size_t len)
+{
+  sfile_reserve (f, len);
+  memcpy (f->buffer + f->pos, s, len);
+  f->pos += len;
+  f->buffer[f->pos] = '\0';
+}
+
+/* Append VALUE to F, in decimal or in lower case hex if HEX, with a
+   leading '-' if NEGATIVE.  Return the number of characters
+   written.  */
+
+static size_t
+sfile_append_number (SFILE *f, unsigned long value, bool hex, bool negative)
+{
+  char digits[sizeof (value) * 3 + 2];
+  char *p = digits + sizeof (digits);
+  unsigned int base = hex ? 16 : 10;
+
+  do
+    {
+      *--p = "0123456789abcdef"[value % base];
+      value /= base;
+    }
+  while (value != 0);
+  if (negative)
+    *--p = '-';
+
+  sfile_append (f, p, digits + sizeof (digits) - p);
+  return digits + sizeof (digits) - p;
+}
+
+/* The printf formats which objdump_sprintf and objdump_styled_sprintf
+   handle without calling vsnprintf.  Nearly every token printed by the
+   disassemblers uses one of these.  */
+
+enum sfile_format
+{
+  sfile_format_other,
+  sfile_format_literal,		/* No conversions at all.  */
+  sfile_format_string,		/* "%s"  */
+  sfile_format_char,		/* "%c"  */
+  sfile_format_int,		/* "%d"  */
+  sfile_format_unsigned,	/* "%u"  */
+  sfile_format_hex,		/* "%x"  */
+  sfile_format_0xhex		/* "0x%x"  */
+};
+
+static enum sfile_format
+sfile_classify_format (const char *format)
+{
+  if (format[0] == '%')
+    {
+      if (format[1] == '\0' || format[2] != '\0')
+	return sfile_format_other;
+      switch (format[1])
+	{
+	case 's': return sfile_format_string;
+	case 'c': return sfile_format_char;
+	case 'd': return sfile_format_int;
+	case 'u': return sfile_format_unsigned;
+	case 'x': return sfile_format_hex;
+	default: return sfile_format_other;
+	}
+    }
+  if (strcmp (format, "0x%x") == 0)
+    return sfile_format_0xhex;
+  if (strchr (format, '%') == NULL)
+    return sfile_format_literal;
+  return sfile_format_other;
+}
+
+/* vsprintf FORMAT and ARGS to F.  */
+
+static int
+sfile_vprintf (SFILE *f, const char *format, va_list args)
 {
   size_t n;
-  va_list args;
+  const char *string;
+  char c;
+  int i;
+
+  switch (sfile_classify_format (format))
+    {
+    case sfile_format_literal:
+      n = strlen (format);
+      sfile_append (f, format, n);
+      return n;
+    case sfile_format_string:
+      string = va_arg (args, const char *);
+      if (string == NULL)
+	string = "(null)";
+      n = strlen (string);
+      sfile_append (f, string, n);
+      return n;
+    case sfile_format_char:
+      c = va_arg (args, int);
+      sfile_append (f, &c, 1);
+      return 1;
+    case sfile_format_int:
+      i = va_arg (args, int);
+      return sfile_append_number (f, (i < 0
+				      ? -(unsigned long) i : (unsigned long) i),
+				  false, i < 0);
+    case sfile_format_unsigned:
+      return sfile_append_number (f, va_arg (args, unsigned int),
+				  false, false);
+    case sfile_format_hex:
+      return sfile_append_number (f, va_arg (args, unsigned int),
+				  true, false);
+    case sfile_format_0xhex:
+      sfile_append (f, "0x", 2);
+      return 2 + sfile_append_number (f, va_arg (args, unsigned int),
+				      true, false);
+    default:
+      break;
+    }
 
   while (1)
     {
       size_t space = f->alloc - f->pos;
+      va_list ap;
 
-      va_start (args, format);
-      n = vsnprintf (f->buffer + f->pos, space, format, args);
-      va_end (args);
+      va_copy (ap, args);
+      n = vsnprintf (f->buffer + f->pos, space, format, ap);
+      va_end (ap);
 
       if (space > n)
 	break;
@@ -2373,6 +2512,21 @@ objdump_sprintf (SFILE *f, const char *format, ...)
   return n;
 }
 
+/* sprintf to a "stream".  */
+
+static int ATTRIBUTE_PRINTF_2
+objdump_sprintf (SFILE *f, const char *format, ...)
+{
+  int n;
+  va_list args;
+
+  va_start (args, format);
+  n = sfile_vprintf (f, format, args);
+  va_end (args);
+
+  return n;
+}
+
 /* Return an integer greater than, or equal to zero, representing the color
    for STYLE, or -1 if no color should be used.  */
 
@@ -2455,61 +2609,26 @@ static int ATTRIBUTE_PRINTF_3
 objdump_styled_sprintf (SFILE *f, enum disassembler_style style,
 			const char *format, ...)
 {
-  size_t n;
+  int n;
   va_list args;
   int color = objdump_color_for_disassembler_style (style);
 
   if (color >= 0)
     {
-      while (1)
-	{
-	  size_t space = f->alloc - f->pos;
-
-	  if (disassembler_color == on)
-	    n = snprintf (f->buffer + f->pos, space, "\033[%dm", color);
-	  else
-	    n = snprintf (f->buffer + f->pos, space, "\033[38;5;%dm", color);
-	  if (space > n)
-	    break;
-
-	  f->alloc = (f->alloc + n) * 2;
-	  f->buffer = (char *) xrealloc (f->buffer, f->alloc);
-	}
-      f->pos += n;
+      if (disassembler_color == on)
+	sfile_append (f, "\033[", 2);
+      else
+	sfile_append (f, "\033[38;5;", 7);
+      sfile_append_number (f, color, false, false);
+      sfile_append (f, "m", 1);
     }
 
-  while (1)
-    {
-      size_t space = f->alloc - f->pos;
-
-      va_start (args, format);
-      n = vsnprintf (f->buffer + f->pos, space, format, args);
-      va_end (args);
-
-      if (space > n)
-	break;
-
-      f->alloc = (f->alloc + n) * 2;
-      f->buffer = (char *) xrealloc (f->buffer, f->alloc);
-    }
-  f->pos += n;
+  va_start (args, format);
+  n = sfile_vprintf (f, format, args);
+  va_end (args);
 
   if (color >= 0)
-    {
-      while (1)
-	{
-	  size_t space = f->alloc - f->pos;
-
-	  n = snprintf (f->buffer + f->pos, space, "\033[0m");
-
-	  if (space > n)
-	    break;
-
-	  f->alloc = (f->alloc + n) * 2;
-	  f->buffer = (char *) xrealloc (f->buffer, f->alloc);
-	}
-      f->pos += n;
-    }
+    sfile_append (f, "\033[0m", 4);
 
   return n;
 }
@@ -3195,6 +3314,16 @@ print_jump_visualisation (bfd_vma addr, int max_level, char *line_buffer,
     }
 }
 
+/* Print the octet C as two hex digits.  This is done for every octet
+   of raw instruction bytes, so avoid printf.  */
+
+static inline void
+print_hex_octet (unsigned int c)
+{
+  putchar ("0123456789abcdef"[(c >> 4) & 0xf]);
+  putchar ("0123456789abcdef"[c & 0xf]);
+}
+
 /* Disassemble some data in memory between given values.  */
 
 static void
@@ -3508,12 +3637,12 @@ disassemble_bytes (struct disassemble_info *inf,
 		      if (inf->display_endian == BFD_ENDIAN_LITTLE)
 			{
 			  for (k = bpc; k-- != 0; )
-			    printf ("%02x", (unsigned) data[j + k]);
+			    print_hex_octet (data[j + k]);
 			}
 		      else
 			{
 			  for (k = 0; k < bpc; k++)
-			    printf ("%02x", (unsigned) data[j + k]);
+			    print_hex_octet (data[j + k]);
 			}
 		    }
 		  putchar (' ');
@@ -3538,7 +3667,7 @@ disassemble_bytes (struct disassemble_info *inf,
 	  if (! insns)
 	    printf ("%s", buf);
 	  else if (sfile.pos)
-	    printf ("%s", sfile.buffer);
+	    fputs (sfile.buffer, stdout);
 
 	  if (prefix_addresses
 	      ? show_raw_insn > 0
@@ -3581,12 +3710,12 @@ disassemble_bytes (struct disassemble_info *inf,
 			  if (inf->display_endian == BFD_ENDIAN_LITTLE)
 			    {
 			      for (k = bpc; k-- != 0; )
-				printf ("%02x", (unsigned) data[j + k]);
+				print_hex_octet (data[j + k]);
 			    }
 			  else
 			    {
 			      for (k = 0; k < bpc; k++)
-				printf ("%02x", (unsigned) data[j + k]);
+				print_hex_octet (data[j + k]);
 			    }
 			}
 		      putchar (' ');
@@ -3679,6 +3808,108 @@ disassemble_bytes (struct disassemble_info *inf,
   free (color_buffer);
 }
 
+/* Return true if SECTION should be disassembled, and set *ADDR_OFFSET
+   and *STOP_OFFSET to the range of octets, in units of OPB, to
+   disassemble.  */
+
+static bool
+disassemble_section_range (asection *section, unsigned int opb,
+			   bfd_vma *addr_offset, bfd_vma *stop_offset)
+{
+  bfd_size_type datasize;
+
+  if (only_list == NULL)
+    {
+      /* Sections that do not contain machine
+	 code are not normally disassembled.  */
+      if ((section->flags & SEC_HAS_CONTENTS) == 0)
+	return false;
+
+      if (! disassemble_all
+	  && (section->flags & SEC_CODE) == 0)
+	return false;
+    }
+  else if (!process_section_p (section))
+    return false;
+
+  datasize = bfd_section_size (section);
+  if (datasize == 0)
+    return false;
+
+  if (start_address == (bfd_vma) -1
+      || start_address < section->vma)
+    *addr_offset = 0;
+  else
+    *addr_offset = start_address - section->vma;
+
+  if (stop_address == (bfd_vma) -1)
+    *stop_offset = datasize / opb;
+  else
+    {
+      if (stop_address < section->vma)
+	*stop_offset = 0;
+      else
+	*stop_offset = stop_address - section->vma;
+      if (*stop_offset > datasize / opb)
+	*stop_offset = datasize / opb;
+    }
+
+  return *addr_offset < *stop_offset;
+}
+
+/* When disassembling in parallel, the disassembly of all the sections
+   is treated as one range, and each worker prints the blocks which
+   start in its own chunk of that range.  DISASM_SECTION_POS holds the
+   position of the start of each section in the range, indexed by
+   section index, and is NULL when not disassembling in parallel.  */
+
+static bfd_vma *disasm_section_pos;
+static bfd_vma disasm_chunk_start;
+static bfd_vma disasm_chunk_end;
+
+/* Some disassemblers carry state from one instruction to the next,
+   for instance to annotate an address built up by a pair of
+   instructions, or to track ARM mapping symbols.  So each job also
+   runs the disassembler, without printing, over the blocks which end
+   less than this far before the start of its chunk.  This is only a
+   heuristic: state which reaches further back than this, or which
+   is carried over from an earlier section, may be lost at the start
+   of a chunk.  */
+#define DISASM_CHUNK_LEAD_IN 0x10000
+
+/* Return true if this process prints the block which starts at
+   ADDR_OFFSET in SECTION.  */
+
+static inline bool
+disassemble_chunk_p (asection *section, bfd_vma addr_offset)
+{
+  bfd_vma pos;
+
+  if (disasm_section_pos == NULL)
+    return true;
+
+  pos = disasm_section_pos[section->index] + addr_offset;
+  return pos >= disasm_chunk_start && pos < disasm_chunk_end;
+}
+
+/* Return true if this process prints, or leads in to, any of the
+   blocks which start between ADDR_OFFSET and STOP_OFFSET in
+   SECTION.  */
+
+static bool
+disassemble_chunk_overlaps_p (asection *section, bfd_vma addr_offset,
+			      bfd_vma stop_offset)
+{
+  bfd_vma pos;
+
+  if (disasm_section_pos == NULL)
+    return true;
+
+  pos = disasm_section_pos[section->index];
+  return (pos + stop_offset + DISASM_CHUNK_LEAD_IN > disasm_chunk_start
+	  && pos + addr_offset < disasm_chunk_end);
+}
+
 static void
 disassemble_section (bfd *abfd, asection *section, void *inf)
 {
@@ -3697,7 +3928,8 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
   long place = 0;
   long rel_count;
   bfd_vma rel_offset;
-  unsigned long addr_offset;
+  bfd_vma addr_offset;
+  bfd_vma chunk_offset;
   bool do_print;
   enum loop_control
   {
@@ -3706,43 +3938,15 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
    next_sym
   } loop_until;
 
-  if (only_list == NULL)
-    {
-      /* Sections that do not contain machine
-	 code are not normally disassembled.  */
-      if ((section->flags & SEC_HAS_CONTENTS) == 0)
-	return;
-
-      if (! disassemble_all
-	  && (section->flags & SEC_CODE) == 0)
-	return;
-    }
-  else if (!process_section_p (section))
+  if (!disassemble_section_range (section, opb, &addr_offset, &stop_offset))
     return;
-
   datasize = bfd_section_size (section);
-  if (datasize == 0)
-    return;
 
-  if (start_address == (bfd_vma) -1
-      || start_address < section->vma)
-    addr_offset = 0;
-  else
-    addr_offset = start_address - section->vma;
-
-  if (stop_address == (bfd_vma) -1)
-    stop_offset = datasize / opb;
-  else
-    {
-      if (stop_address < section->vma)
-	stop_offset = 0;
-      else
-	stop_offset = stop_address - section->vma;
-      if (stop_offset > datasize / opb)
-	stop_offset = datasize / opb;
-    }
-
-  if (addr_offset >= stop_offset)
+  /* When disassembling in parallel, skip the sections which are
+     entirely outside the chunk printed by this process.  There is no
+     need to sort the symbols for them, as compare_symbols only falls
+     back on the previous order for symbols which print the same.  */
+  if (!disassemble_chunk_overlaps_p (section, addr_offset, stop_offset))
     return;
 
   /* Decide which set of relocs to use.  Load them if necessary.  */
@@ -3814,7 +4018,9 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
 	 && (*rel_pp)->address < rel_offset + addr_offset)
     ++rel_pp;
 
-  printf (_("\nDisassembly of section %s:\n"), sanitize_string (section->name));
+  if (disassemble_chunk_p (section, addr_offset))
+    printf (_("\nDisassembly of section %s:\n"),
+	    sanitize_string (section->name));
 
   /* Find the nearest symbol forwards from our current position.  */
   paux->require_sec = true;
@@ -3837,6 +4043,7 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
      or we have reached the end of the address range we are interested in.  */
   do_print = paux->symbol == NULL;
   loop_until = stop_offset_reached;
+  chunk_offset = addr_offset;
 
   while (addr_offset < stop_offset)
     {
@@ -3844,10 +4051,20 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
       asymbol *nextsym;
       bfd_vma nextstop_offset;
       bool insns;
+      bool in_chunk;
 
       addr = section->vma + addr_offset;
       addr = ((addr & ((sign_adjust << 1) - 1)) ^ sign_adjust) - sign_adjust;
 
+      /* When disassembling in parallel, the jobs only start at function
+	 symbols, as a disassembler may carry state from one instruction
+	 to the next.  */
+      if (sym != NULL
+	  && bfd_asymbol_value (sym) == addr
+	  && (sym->flags & BSF_FUNCTION) != 0)
+	chunk_offset = addr_offset;
+      in_chunk = disassemble_chunk_p (section, chunk_offset);
+
       if (sym != NULL && bfd_asymbol_value (sym) <= addr)
 	{
 	  int x;
@@ -3952,7 +4169,7 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
 	    }
 	}
 
-      if (! prefix_addresses && do_print)
+      if (! prefix_addresses && do_print && in_chunk)
 	{
 	  pinfo->fprintf_func (pinfo->stream, "\n");
 	  objdump_print_addr_with_sym (abfd, section, sym, addr,
@@ -4031,7 +4248,38 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
       else
 	insns = false;
 
-      if (do_print)
+      if (do_print && !in_chunk)
+	{
+	  /* Another process prints this block.  If it ends shortly
+	     before the chunk printed by this process, disassemble it
+	     without printing anything, as the serial code would have
+	     done before reaching the chunk.  Skip its relocs.  */
+	  bfd_vma pos = disasm_section_pos[section->index];
+
+	  if (insns
+	      && pos + chunk_offset < disasm_chunk_start
+	      && (pos + nextstop_offset + DISASM_CHUNK_LEAD_IN
+		  > disasm_chunk_start))
+	    {
+	      int pass;
+
+	      /* With --visualize-jumps every block is run through the
+		 disassembler twice.  */
+	      for (pass = visualize_jumps ? 2 : 1; pass > 0; pass--)
+		{
+		  detected_jumps = disassemble_jumps
+		    (pinfo, paux->disassemble_fn, addr_offset,
+		     nextstop_offset, rel_offset, &rel_pp, rel_ppend);
+		  while (detected_jumps)
+		    detected_jumps = jump_info_free (detected_jumps);
+		}
+	    }
+
+	  while (rel_pp < rel_ppend
+		 && (*rel_pp)->address < rel_offset + nextstop_offset)
+	    ++rel_pp;
+	}
+      else if (do_print)
 	{
 	  /* Resolve symbol name.  */
 	  if (visualize_jumps && abfd && sym && sym->name)
@@ -4080,6 +4328,111 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
     free (rel_ppstart);
 }
 
+#if defined (HAVE_FORK) && defined (HAVE_SYS_WAIT_H)
+/* Disassemble the sections of ABFD with DISASSEMBLE_JOBS parallel
+   jobs.  Neither BFD nor the disassemblers are thread safe, so each
+   job is a forked copy of objdump which prints one chunk of the
+   disassembly to a temporary file.  Every job skips the sections
+   outside its chunk, and only disassembles the blocks of the other
+   sections which start in its chunk or lead in to it.  The files are
+   copied to stdout in order once all the jobs have finished.  Return
+   false if nothing was done.  */
+
+static bool
+disassemble_sections_in_parallel (bfd *abfd, struct disassemble_info *pinfo)
+{
+  unsigned int opb = pinfo->octets_per_byte;
+  unsigned int jobs = disassemble_jobs;
+  bfd_vma total = 0;
+  asection *section;
+  FILE **files;
+  pid_t *pids;
+  unsigned int i;
+
+  /* Options which carry state from one block of the disassembly to
+     the next are not supported.  */
+  if (with_line_numbers || with_source_code || show_all_symbols
+      || disasm_sym != NULL)
+    return false;
+
+  disasm_section_pos = (bfd_vma *) xcalloc (bfd_count_sections (abfd),
+					    sizeof (bfd_vma));
+  for (section = abfd->sections; section != NULL; section = section->next)
+    {
+      bfd_vma addr_offset, stop_offset;
+
+      disasm_section_pos[section->index] = total;
+      if (disassemble_section_range (section, opb, &addr_offset,
+				     &stop_offset))
+	total += stop_offset;
+    }
+
+  if ((bfd_vma) jobs > total)
+    jobs = total;
+  if (jobs < 2)
+    {
+      free (disasm_section_pos);
+      disasm_section_pos = NULL;
+      return false;
+    }
+
+  files = (FILE **) xmalloc (jobs * sizeof (*files));
+  pids = (pid_t *) xmalloc (jobs * sizeof (*pids));
+  fflush (stdout);
+  /* Make each job open the input files itself, rather than share the
+     file offsets of the open descriptors.  */
+  bfd_cache_close_all ();
+  for (i = 0; i < jobs; i++)
+    {
+      files[i] = tmpfile ();
+      if (files[i] == NULL)
+	fatal (_("cannot create temporary file: %s"), strerror (errno));
+
+      pids[i] = fork ();
+      if (pids[i] < 0)
+	fatal (_("cannot fork: %s"), strerror (errno));
+      if (pids[i] == 0)
+	{
+	  disasm_chunk_start = total / jobs * i;
+	  disasm_chunk_end = (i + 1 == jobs
+			      ? total : total / jobs * (i + 1));
+	  if (dup2 (fileno (files[i]), fileno (stdout)) < 0)
+	    _exit (1);
+	  bfd_map_over_sections (abfd, disassemble_section, pinfo);
+	  fflush (stdout);
+	  _exit (exit_status);
+	}
+    }
+
+  for (i = 0; i < jobs; i++)
+    {
+      char buf[8192];
+      size_t n;
+      int status;
+
+      if (waitpid (pids[i], &status, 0) != pids[i]
+	  || !WIFEXITED (status))
+	{
+	  non_fatal (_("disassembly job %u failed"), i);
+	  exit_status = 1;
+	}
+      else if (WEXITSTATUS (status) != 0)
+	exit_status = 1;
+
+      rewind (files[i]);
+      while ((n = fread (buf, 1, sizeof (buf), files[i])) != 0)
+	fwrite (buf, 1, n, stdout);
+      fclose (files[i]);
+    }
+
+  free (pids);
+  free (files);
+  free (disasm_section_pos);
+  disasm_section_pos = NULL;
+  return true;
+}
+#endif
+
 /* Disassemble the contents of an object file.  */
 
 static void
@@ -4209,7 +4562,11 @@ disassemble_data (bfd *abfd)
   disasm_info.symtab = sorted_syms;
   disasm_info.symtab_size = sorted_symcount;
 
-  bfd_map_over_sections (abfd, disassemble_section, & disasm_info);
+#if defined (HAVE_FORK) && defined (HAVE_SYS_WAIT_H)
+  if (disassemble_jobs <= 1
+      || !disassemble_sections_in_parallel (abfd, &disasm_info))
+#endif
+    bfd_map_over_sections (abfd, disassemble_section, & disasm_info);
 
   free (disasm_info.dynrelbuf);
   disasm_info.dynrelbuf = NULL;
@@ -6001,6 +6358,20 @@ main (int argc, char **argv)
 	case OPTION_INLINES:
 	  unwind_inlines = true;
 	  break;
+	case OPTION_JOBS:
+	  {
+	    unsigned long jobs;
+	    char *end;
+
+	    errno = 0;
+	    jobs = strtoul (optarg, &end, 0);
+	    if (errno != 0 || end == optarg || *end != '\0'
+		|| jobs < 1 || jobs > MAX_DISASSEMBLE_JOBS)
+	      fatal (_("error: number of jobs must be between 1 and %d"),
+		     MAX_DISASSEMBLE_JOBS);
+	    disassemble_jobs = jobs;
+	  }
+	  break;
 	case OPTION_VISUALIZE_JUMPS:
 	  visualize_jumps = true;
 	  color_output = false;
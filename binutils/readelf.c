@@ -48,6 +48,9 @@
 #include <zstd.h>
 #endif
 #include <wchar.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 #if defined HAVE_MSGPACK
 #include <msgpack.h>
@@ -274,6 +277,9 @@ typedef struct filedata
   bool                 is_separate;
   FILE *               handle;
   uint64_t             file_size;
+  /* The contents of the file, if it could be mapped into memory.  */
+  unsigned char *      map;
+  uint64_t             map_size;
   Elf_Internal_Ehdr    file_header;
   uint64_t             archive_file_offset;
   uint64_t             archive_file_size;
@@ -467,6 +473,60 @@ get_dynamic_name (const Filedata *filedata, size_t offset)
 #define GNU_HASH_SECTION_NAME(filedata)		\
   filedata->dynamic_info_DT_MIPS_XHASH ? ".MIPS.xhash" : ".gnu.hash"
 
+/* Map the file of FILEDATA into memory, so that get_data and
+   load_specific_debug_section can use it instead of reading the file.
+   If this fails, the file is just read as before.  */
+
+static void
+map_file (Filedata *filedata)
+{
+#ifdef HAVE_MMAP
+  void *map;
+
+  if (filedata->file_size == 0
+      || (size_t) filedata->file_size != filedata->file_size)
+    return;
+
+  /* The mapping is private and writable so that anything which alters
+     the data it is given, as apply_relocations does, only changes its
+     own copy of the pages.  */
+  map = mmap (NULL, filedata->file_size, PROT_READ | PROT_WRITE,
+	      MAP_PRIVATE, fileno (filedata->handle), 0);
+  if (map == MAP_FAILED)
+    return;
+
+  filedata->map = (unsigned char *) map;
+  filedata->map_size = filedata->file_size;
+#endif
+}
+
+static void
+unmap_file (Filedata *filedata)
+{
+#ifdef HAVE_MMAP
+  if (filedata->map != NULL)
+    munmap (filedata->map, filedata->map_size);
+#endif
+  filedata->map = NULL;
+  filedata->map_size = 0;
+}
+
+/* Return a pointer to the SIZE bytes at OFFSET + the offset of the
+   current archive member in the mapping of FILEDATA's file, or NULL if
+   the file is not mapped or they are not all within it.  */
+
+static unsigned char *
+get_mapped_data (Filedata *filedata, uint64_t offset, uint64_t size)
+{
+  if (filedata->map == NULL
+      || filedata->archive_file_offset > filedata->map_size
+      || offset > filedata->map_size - filedata->archive_file_offset
+      || size > filedata->map_size - filedata->archive_file_offset - offset)
+    return NULL;
+
+  return filedata->map + filedata->archive_file_offset + offset;
+}
+
 /* Retrieve NMEMB structures, each SIZE bytes long from FILEDATA starting at
    OFFSET + the offset of the current archive member, if we are examining an
    archive.  Put the retrieved data into VAR, if it is not NULL.  Otherwise
@@ -485,6 +545,7 @@ get_data (void *var,
 {
   void * mvar;
   uint64_t amt = size * nmemb;
+  unsigned char *mapped;
 
   if (size == 0 || nmemb == 0)
     return NULL;
@@ -517,8 +578,10 @@ get_data (void *var,
       return NULL;
     }
 
-  if (fseek64 (filedata->handle, filedata->archive_file_offset + offset,
-	       SEEK_SET))
+  mapped = get_mapped_data (filedata, offset, amt);
+  if (mapped == NULL
+      && fseek64 (filedata->handle, filedata->archive_file_offset + offset,
+		  SEEK_SET))
     {
       if (reason)
 	error (_("Unable to seek to %#" PRIx64 " for %s\n"),
@@ -543,7 +606,10 @@ get_data (void *var,
       ((char *) mvar)[amt] = '\0';
     }
 
-  if (fread (mvar, (size_t) size, (size_t) nmemb, filedata->handle) != nmemb)
+  if (mapped != NULL)
+    memcpy (mvar, mapped, (size_t) amt);
+  else if (fread (mvar, (size_t) size, (size_t) nmemb,
+		  filedata->handle) != nmemb)
     {
       if (reason)
 	error (_("Unable to read in %" PRIu64 " bytes of %s\n"),
@@ -16545,6 +16611,10 @@ dump_section_as_sframe (Elf_Internal_Shdr * section, Filedata * filedata)
   return ret;
 }
 
+/* Set for the debug sections whose start points into the mapping of
+   their file, rather than to memory which must be freed.  */
+static bool debug_section_mapped[max];
+
 static bool
 load_specific_debug_section (enum dwarf_section_display_enum  debug,
 			     const Elf_Internal_Shdr *        sec,
@@ -16559,15 +16629,30 @@ load_specific_debug_section (enum dwarf_section_display_enum  debug,
       /* If it is already loaded, do nothing.  */
       if (streq (section->filename, filedata->file_name))
 	return true;
-      free (section->start);
+      if (!debug_section_mapped[debug])
+	free (section->start);
+      debug_section_mapped[debug] = false;
     }
 
   snprintf (buf, sizeof (buf), _("%s section data"), section->name);
   section->address = sec->sh_addr;
   section->filename = filedata->file_name;
-  section->start = (unsigned char *) get_data (NULL, filedata,
-                                               sec->sh_offset, 1,
-                                               sec->sh_size, buf);
+
+  /* Use the data in place if the file is mapped, unless relocations
+     are going to be applied to it.  Compressed sections are then
+     decompressed straight from the mapping.  */
+  section->start = NULL;
+  if (sec->sh_size != 0
+      && sec->sh_type != SHT_NOBITS
+      && !(debug_displays [debug].relocate
+	   && filedata->file_header.e_type == ET_REL))
+    section->start = get_mapped_data (filedata, sec->sh_offset, sec->sh_size);
+  if (section->start != NULL)
+    debug_section_mapped[debug] = true;
+  else
+    section->start = (unsigned char *) get_data (NULL, filedata,
+						 sec->sh_offset, 1,
+						 sec->sh_size, buf);
   if (section->start == NULL)
     section->size = 0;
   else
@@ -16637,7 +16722,9 @@ load_specific_debug_section (enum dwarf_section_display_enum  debug,
 	    {
 	      /* Free the compressed buffer, update the section buffer
 		 and the section size if uncompress is successful.  */
-	      free (section->start);
+	      if (!debug_section_mapped[debug])
+		free (section->start);
+	      debug_section_mapped[debug] = false;
 	      section->start = start;
 	    }
 	  else
@@ -16875,7 +16962,9 @@ free_debug_section (enum dwarf_section_display_enum debug)
   if (section->start == NULL)
     return;
 
-  free ((char *) section->start);
+  if (!debug_section_mapped[debug])
+    free ((char *) section->start);
+  debug_section_mapped[debug] = false;
   section->start = NULL;
   section->address = 0;
   section->size = 0;
@@ -22964,6 +23053,7 @@ close_file (Filedata * filedata)
 {
   if (filedata)
     {
+      unmap_file (filedata);
       if (filedata->handle)
 	fclose (filedata->handle);
       free (filedata);
@@ -22998,6 +23088,7 @@ open_file (const char * pathname, bool is_separate)
   filedata->file_size = statbuf.st_size;
   filedata->file_name = pathname;
   filedata->is_separate = is_separate;
+  map_file (filedata);
 
   if (! get_file_header (filedata))
     goto fail;
@@ -23010,6 +23101,7 @@ open_file (const char * pathname, bool is_separate)
  fail:
   if (filedata)
     {
+      unmap_file (filedata);
       if (filedata->handle)
         fclose (filedata->handle);
       free (filedata);
@@ -23557,6 +23649,7 @@ process_file (char * file_name)
 
   filedata->file_size = statbuf.st_size;
   filedata->is_separate = false;
+  map_file (filedata);
 
   if (memcmp (armag, ARMAG, SARMAG) == 0)
     {
@@ -23581,6 +23674,7 @@ process_file (char * file_name)
 	ret = false;
     }
 
+  unmap_file (filedata);
   fclose (filedata->handle);
   free (filedata->section_headers);
   free (filedata->program_headers);
@@ -90,6 +90,10 @@
 #include "safe-ctype.h"
 #include "bucomm.h"
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 #ifndef streq
 #define streq(a,b) (strcmp ((a),(b)) == 0)
 #endif
@@ -117,6 +121,10 @@ static unicode_display_type unicode_display = unicode_default;
 extern int errno;
 #endif
 
+/* STRING_ISGRAPHIC for each byte value, for the single byte encodings.
+   Set up by init_graphic_table.  */
+static bool graphic_table[256];
+
 /* The BFD section flags that identify an initialized data section.  */
 #define DATA_FLAGS (SEC_ALLOC | SEC_LOAD | SEC_HAS_CONTENTS)
 
@@ -167,6 +175,9 @@ static struct option long_options[] =
 
 static bool strings_file (char *);
 static void print_strings (const char *, FILE *, file_ptr, int, char *);
+static void print_strings_buffer (const char *, file_ptr,
+				  const unsigned char *, size_t);
+static void init_graphic_table (void);
 static void usage (FILE *, int) ATTRIBUTE_NORETURN;
 
 int main (int, char **);
@@ -352,6 +363,8 @@ main (int argc, char **argv)
       usage (stderr, 1);
     }
 
+  init_graphic_table ();
+
   if (bfd_init () != BFD_INIT_MAGIC)
     fatal (_("fatal error: libbfd ABI mismatch"));
   set_default_bfd_target ();
@@ -486,6 +499,34 @@ strings_file (char *file)
     {
       FILE *stream;
 
+#ifdef HAVE_MMAP
+      /* Scan regular files in place rather than through stdio, unless
+	 the characters need more than a byte each.  */
+      if (encoding_bytes == 1
+	  && unicode_display == unicode_default
+	  && S_ISREG (st.st_mode)
+	  && st.st_size > 0
+	  && st.st_size == (off_t) (size_t) st.st_size)
+	{
+	  int fd = open (file, O_RDONLY | O_BINARY);
+
+	  if (fd >= 0)
+	    {
+	      void *map = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+				fd, 0);
+
+	      close (fd);
+	      if (map != MAP_FAILED)
+		{
+		  print_strings_buffer (file, 0, (const unsigned char *) map,
+					st.st_size);
+		  munmap (map, st.st_size);
+		  return true;
+		}
+	    }
+	}
+#endif
+
       stream = fopen (file, FOPEN_RB);
       if (stream == NULL)
 	{
@@ -1241,6 +1282,168 @@ print_unicode_stream (const char * filename,
   free (print_buf);
 }
 
+/* Set up graphic_table for the selected encoding.  */
+
+static void
+init_graphic_table (void)
+{
+  int c;
+
+  for (c = 0; c < 256; c++)
+    graphic_table[c] = STRING_ISGRAPHIC (c);
+}
+
+/* Return the offset of the first byte at or after I in BUF, which is
+   LEN bytes long, that is not a graphic character, or LEN.  */
+
+static size_t
+find_graphic_run_end (const unsigned char *buf, size_t i, size_t len)
+{
+  const uint64_t ones = 0x0101010101010101ULL;
+  const uint64_t highs = 0x8080808080808080ULL;
+
+  /* Check eight bytes at a time whether they are all in the range
+     ' ' to '~', which are graphic in every single byte encoding.  A
+     byte below ' ' sets its high bit in (W - ' ' * ONES) & ~W, and a
+     byte above '~' sets its high bit in (W + ONES) | W.  */
+  while (len - i >= 8)
+    {
+      uint64_t w;
+
+      memcpy (&w, buf + i, 8);
+      if ((((w - ' ' * ones) & ~w) | ((w + ones) | w)) & highs)
+	break;
+      i += 8;
+    }
+
+  while (i < len && graphic_table[buf[i]])
+    i++;
+  return i;
+}
+
+/* Print the run of LEN graphic characters at BUF, which was found at
+   ADDRESS in FILENAME.  If COMPLETE, it is the whole string, so also
+   print the separator.  */
+
+static void
+print_graphic_run (const char *filename, file_ptr address,
+		   const unsigned char *buf, size_t len, bool complete)
+{
+  print_filename_and_address (filename, address);
+  fwrite (buf, 1, len, stdout);
+  if (complete)
+    {
+      if (output_separator)
+	fputs (output_separator, stdout);
+      else
+	putchar ('\n');
+    }
+}
+
+/* Find the strings in the LEN bytes at BUF, which come from ADDRESS in
+   file FILENAME.  This is only used for the single byte encodings, and
+   gives the same output as print_strings without reading the data one
+   character at a time.  */
+
+static void
+print_strings_buffer (const char *filename, file_ptr address,
+		      const unsigned char *buf, size_t len)
+{
+  size_t i = 0;
+
+  while (i < len)
+    {
+      size_t start;
+
+      while (i < len && !graphic_table[buf[i]])
+	i++;
+      if (i == len)
+	break;
+
+      start = i;
+      i = find_graphic_run_end (buf, i, len);
+      if (i - start >= string_min)
+	print_graphic_run (filename, address + start, buf + start,
+			   i - start, true);
+    }
+}
+
+/* Like print_strings_buffer, but read the data from STREAM, which is
+   positioned at ADDRESS in FILENAME.  */
+
+static void
+print_strings_stream (const char *filename, file_ptr address, FILE *stream)
+{
+  /* A partial run at the end of the buffer which is too short to be
+     printed yet is moved to the start of the buffer, so the buffer
+     must have room for it.  */
+  size_t size = 65536 + string_min;
+  unsigned char *buf = (unsigned char *) xmalloc (size);
+  size_t keep = 0;
+  bool printing = false;
+  size_t n;
+
+  while ((n = fread (buf + keep, 1, size - keep, stream)) != 0)
+    {
+      size_t len = keep + n;
+      size_t i = 0;
+
+      keep = 0;
+      if (printing)
+	{
+	  /* Continue the string printed from the previous buffer.  */
+	  i = find_graphic_run_end (buf, 0, len);
+	  fwrite (buf, 1, i, stdout);
+	  if (i < len)
+	    {
+	      if (output_separator)
+		fputs (output_separator, stdout);
+	      else
+		putchar ('\n');
+	      printing = false;
+	    }
+	}
+
+      while (i < len)
+	{
+	  size_t start;
+
+	  while (i < len && !graphic_table[buf[i]])
+	    i++;
+	  if (i == len)
+	    break;
+
+	  start = i;
+	  i = find_graphic_run_end (buf, i, len);
+	  if (i == len && i - start < string_min)
+	    {
+	      /* The run may continue in the next buffer.  */
+	      keep = i - start;
+	      memmove (buf, buf + start, keep);
+	      address += start;
+	      len = 0;
+	      break;
+	    }
+	  if (i - start >= string_min)
+	    {
+	      printing = i == len;
+	      print_graphic_run (filename, address + start, buf + start,
+				 i - start, !printing);
+	    }
+	}
+      address += len;
+    }
+
+  if (printing)
+    {
+      if (output_separator)
+	fputs (output_separator, stdout);
+      else
+	putchar ('\n');
+    }
+  free (buf);
+}
+
 /* Find the strings in file FILENAME, read from STREAM.
    Assume that STREAM is positioned so that the next byte read
    is at address ADDRESS in the file.
@@ -1267,6 +1470,16 @@ print_strings (const char *filename, FILE *stream, file_ptr address,
       return;
     }
 
+  if (encoding_bytes == 1 && (stream == NULL || magic == NULL))
+    {
+      if (magic != NULL)
+	print_strings_buffer (filename, address,
+			      (const unsigned char *) magic, magiccount);
+      if (stream != NULL)
+	print_strings_stream (filename, address, stream);
+      return;
+    }
+
   char *buf = (char *) xmalloc (sizeof (char) * (string_min + 1));
 
   while (1)
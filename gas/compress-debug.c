@@ -20,6 +20,7 @@
 
 #include "config.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <zlib.h>
 #if HAVE_ZSTD
@@ -39,14 +40,16 @@ compress_init (bool use_zstd)
 #endif
   }
 
-  static struct z_stream_s strm;
-  memset (&strm, 0, sizeof (strm));
-  deflateInit (&strm, Z_DEFAULT_COMPRESSION);
-  return &strm;
+  struct z_stream_s *strm = calloc (1, sizeof (*strm));
+  if (strm != NULL && deflateInit (strm, Z_DEFAULT_COMPRESSION) != Z_OK)
+    {
+      free (strm);
+      strm = NULL;
+    }
+  return strm;
 }
 
-/* Stream the contents of a frag to the compression engine.  Output
-   from the engine goes into the current frag on the obstack.  */
+/* Stream the contents of a frag to the compression engine.  */
 
 int
 compress_data (bool use_zstd, void *ctx, const char **next_in, int *avail_in,
@@ -129,9 +132,30 @@ compress_finish (bool use_zstd, void *ctx, char **next_out,
   if (x == Z_STREAM_END)
     {
       deflateEnd (strm);
+      free (strm);
       return 0;
     }
   if (strm->avail_out != 0)
     return -1;
   return 1;
 }
+
+/* Release the compression engine CTX after an error, when
+   compress_finish has not already done so.  */
+
+void
+compress_end (bool use_zstd, void *ctx)
+{
+  if (use_zstd)
+    {
+#if HAVE_ZSTD
+      ZSTD_freeCCtx (ctx);
+      return;
+#endif
+    }
+
+  struct z_stream_s *strm = ctx;
+
+  deflateEnd (strm);
+  free (strm);
+}
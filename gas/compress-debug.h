@@ -28,12 +28,14 @@ struct z_stream_s;
 /* Initialize the compression engine.  */
 extern void *compress_init (bool);
 
-/* Stream the contents of a frag to the compression engine.  Output
-   from the engine goes into the current frag on the obstack.  */
+/* Stream the contents of a frag to the compression engine.  */
 extern int compress_data (bool, void *, const char **, int *, char **, int *);
 
 /* Finish the compression and consume the remaining compressed output.  */
 extern int
 compress_finish (bool, void *, char **, int *, int *);
 
+/* Release the compression engine after an error.  */
+extern void compress_end (bool, void *);
+
 #endif /* COMPRESS_DEBUG_H */
@@ -0,0 +1,9 @@
+	.global	UART1_DR
+	UART1_DR = 0x5231
+
+	.text
+	.global	f
+f:
+	ld	A,0x5231
+	ld	A,0x5000
+	ld	A,0x5231
@@ -21,6 +21,12 @@
 /* This thing should be set up to do byte ordering correctly.  But...  */
 
 #include "as.h"
+#include <limits.h>
+#if defined (HAVE_PTHREAD_H) && defined (HAVE_PTHREAD_CREATE) \
+    && defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+#include <pthread.h>
+#define USE_THREADS 1
+#endif
 #include "subsegs.h"
 #include "obstack.h"
 #include "output-file.h"
@@ -1413,100 +1419,120 @@ write_relocs (bfd *abfd ATTRIBUTE_UNUSED, asection *sec,
 #endif
 }
 
-static int
+/* A debug section for compress_debug_sections to compress.  */
+
+struct compress_debug_job
+{
+  asection *sec;
+  /* The compressed contents, after room for the compression header.  */
+  char *contents;
+  bfd_size_type size;
+  bfd_size_type alloc;
+  bool ok;
+};
+
+struct compress_debug_jobs
+{
+  struct compress_debug_job *jobs;
+  unsigned int count;
+  unsigned int next;
+  bool use_zstd;
+  unsigned int header_size;
+#ifdef USE_THREADS
+  pthread_mutex_t lock;
+#endif
+};
+
+/* Don't start threads unless there is at least this much to compress.  */
+#define COMPRESS_THREADS_MIN_SIZE (1024 * 1024)
+
+/* Return TRUE if SEC is a debug section that should be compressed.  */
+
+static bool
+compress_debug_p (asection *sec)
+{
+  segment_info_type *seginfo = seg_info (sec);
+  flagword flags = bfd_section_flags (sec);
+
+  if (seginfo == NULL
+      || sec->size < 32
+      || (flags & SEC_HAS_CONTENTS) == 0)
+    return false;
+
+  const char *section_name = bfd_section_name (sec);
+  return (startswith (section_name, ".debug_")
+	  || startswith (section_name, ".gnu.debuglto_.debug_")
+	  || startswith (section_name, ".gnu.linkonce.wi."));
+}
+
+/* Make room for more output at the end of JOB's contents.  */
+
+static bool
+compress_debug_room (struct compress_debug_job *job, char **next_out,
+		     int *avail_out)
+{
+  if (job->size == job->alloc)
+    {
+      bfd_size_type alloc = job->alloc * 2;
+      char *contents = realloc (job->contents, alloc);
+
+      if (contents == NULL)
+	return false;
+      job->contents = contents;
+      job->alloc = alloc;
+    }
+
+  *next_out = job->contents + job->size;
+  *avail_out = (job->alloc - job->size > INT_MAX
+		? INT_MAX : (int) (job->alloc - job->size));
+  return true;
+}
+
+static bool
 compress_frag (bool use_zstd, void *ctx, const char *contents, int in_size,
-	       fragS **last_newf, struct obstack *ob)
+	       struct compress_debug_job *job)
 {
-  int out_size;
-  int total_out_size = 0;
-  fragS *f = *last_newf;
   char *next_out;
   int avail_out;
+  int out_size;
 
   /* Call the compression routine repeatedly until it has finished
      processing the frag.  */
   while (in_size > 0)
     {
-      /* Reserve all the space available in the current chunk.
-         If none is available, start a new frag.  */
-      avail_out = obstack_room (ob);
-      if (avail_out <= 0)
-        {
-          obstack_finish (ob);
-          f = frag_alloc (ob);
-	  f->fr_type = rs_fill;
-          (*last_newf)->fr_next = f;
-          *last_newf = f;
-          avail_out = obstack_room (ob);
-        }
-      if (avail_out <= 0)
-	as_fatal (_("can't extend frag"));
-      next_out = obstack_next_free (ob);
-      obstack_blank_fast (ob, avail_out);
+      if (!compress_debug_room (job, &next_out, &avail_out))
+	return false;
       out_size = compress_data (use_zstd, ctx, &contents, &in_size, &next_out,
 				&avail_out);
       if (out_size < 0)
-	return -1;
-
-      f->fr_fix += out_size;
-      total_out_size += out_size;
-
-      /* Return unused space.  */
-      if (avail_out > 0)
-	obstack_blank_fast (ob, -avail_out);
+	return false;
+      job->size += out_size;
     }
 
-  return total_out_size;
+  return true;
 }
 
+/* Compress the contents of JOB's section into JOB.  This only reads
+   the frags of the section, so may be run on several sections at once
+   in different threads.  */
+
 static void
-compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
+compress_debug (struct compress_debug_job *job, bool use_zstd,
+		unsigned int header_size)
 {
-  segment_info_type *seginfo = seg_info (sec);
-  bfd_size_type uncompressed_size = sec->size;
-  flagword flags = bfd_section_flags (sec);
-
-  if (seginfo == NULL
-      || uncompressed_size < 32
-      || (flags & SEC_HAS_CONTENTS) == 0)
-    return;
+  segment_info_type *seginfo = seg_info (job->sec);
 
-  const char *section_name = bfd_section_name (sec);
-  if (!startswith (section_name, ".debug_")
-      && !startswith (section_name, ".gnu.debuglto_.debug_")
-      && !startswith (section_name, ".gnu.linkonce.wi."))
-    return;
-
-  bool use_zstd = abfd->flags & BFD_COMPRESS_ZSTD;
   void *ctx = compress_init (use_zstd);
   if (ctx == NULL)
     return;
 
-  unsigned int header_size;
-  if ((abfd->flags & BFD_COMPRESS_GABI) == 0)
-    header_size = 12;
-  else
-    header_size = bfd_get_compression_header_size (stdoutput, NULL);
+  job->size = header_size;
+  job->alloc = header_size + job->sec->size / 2 + 64;
+  job->contents = malloc (job->alloc);
+  if (job->contents == NULL)
+    goto fail;
 
-  /* Create a new frag to contain the compression header.  */
-  struct obstack *ob = &seginfo->frchainP->frch_obstack;
-  fragS *first_newf = frag_alloc (ob);
-  if (obstack_room (ob) < header_size)
-    first_newf = frag_alloc (ob);
-  if (obstack_room (ob) < header_size)
-    as_fatal (ngettext ("can't extend frag %lu char",
-			"can't extend frag %lu chars",
-			(unsigned long) header_size),
-	      (unsigned long) header_size);
-  fragS *last_newf = first_newf;
-  obstack_blank_fast (ob, header_size);
-  last_newf->fr_type = rs_fill;
-  last_newf->fr_fix = header_size;
-  char *header = last_newf->fr_literal;
-  bfd_size_type compressed_size = header_size;
-
-  /* Stream the frags through the compression engine, adding new frags
-     as necessary to accommodate the compressed output.  */
+  /* Stream the frags through the compression engine.  */
   for (fragS *f = seginfo->frchainP->frch_root;
        f;
        f = f->fr_next)
@@ -1514,17 +1540,11 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
       offsetT fill_size;
       char *fill_literal;
       offsetT count;
-      int out_size;
 
       gas_assert (f->fr_type == rs_fill);
-      if (f->fr_fix)
-	{
-	  out_size = compress_frag (use_zstd, ctx, f->fr_literal, f->fr_fix,
-				    &last_newf, ob);
-	  if (out_size < 0)
-	    return;
-	  compressed_size += out_size;
-	}
+      if (f->fr_fix
+	  && !compress_frag (use_zstd, ctx, f->fr_literal, f->fr_fix, job))
+	goto fail;
       fill_literal = f->fr_literal + f->fr_fix;
       fill_size = f->fr_var;
       count = f->fr_offset;
@@ -1532,26 +1552,104 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
       if (fill_size && count)
 	{
 	  while (count--)
-	    {
-	      out_size = compress_frag (use_zstd, ctx, fill_literal,
-					(int)fill_size, &last_newf, ob);
-	      if (out_size < 0)
-		return;
-	      compressed_size += out_size;
-	    }
+	    if (!compress_frag (use_zstd, ctx, fill_literal, (int) fill_size,
+				job))
+	      goto fail;
 	}
     }
 
   /* Flush the compression state.  */
   for (;;)
     {
-      int avail_out;
       char *next_out;
+      int avail_out;
       int out_size;
 
-      /* Reserve all the space available in the current chunk.
-	 If none is available, start a new frag.  */
-      avail_out = obstack_room (ob);
+      if (!compress_debug_room (job, &next_out, &avail_out))
+	goto fail;
+      int x = compress_finish (use_zstd, ctx, &next_out, &avail_out, &out_size);
+      if (x < 0)
+	goto fail;
+      job->size += out_size;
+      if (x == 0)
+	break;
+    }
+
+  /* compress_finish has released CTX.  */
+  job->ok = true;
+  return;
+
+ fail:
+  compress_end (use_zstd, ctx);
+}
+
+/* Compress jobs from JOBS until there are none left.  */
+
+static void *
+compress_debug_worker (void *arg)
+{
+  struct compress_debug_jobs *jobs = (struct compress_debug_jobs *) arg;
+
+  for (;;)
+    {
+      struct compress_debug_job *job = NULL;
+
+#ifdef USE_THREADS
+      pthread_mutex_lock (&jobs->lock);
+#endif
+      if (jobs->next < jobs->count)
+	job = &jobs->jobs[jobs->next++];
+#ifdef USE_THREADS
+      pthread_mutex_unlock (&jobs->lock);
+#endif
+      if (job == NULL)
+	return NULL;
+
+      compress_debug (job, jobs->use_zstd, jobs->header_size);
+    }
+}
+
+/* Replace the frags of JOB's section with its compressed contents,
+   which start with HEADER_SIZE bytes of room for the header.  */
+
+static void
+install_compressed_debug (bfd *abfd, struct compress_debug_job *job,
+			  unsigned int header_size)
+{
+  asection *sec = job->sec;
+  segment_info_type *seginfo = seg_info (sec);
+  const char *section_name = bfd_section_name (sec);
+  bfd_size_type compressed_size = job->size;
+
+  /* PR binutils/18087: If compression didn't make the section smaller,
+     just keep it uncompressed.  */
+  if (!job->ok || compressed_size >= sec->size)
+    return;
+
+  /* Create a new frag to contain the compression header.  */
+  struct obstack *ob = &seginfo->frchainP->frch_obstack;
+  fragS *first_newf = frag_alloc (ob);
+  if (obstack_room (ob) < header_size)
+    first_newf = frag_alloc (ob);
+  if (obstack_room (ob) < header_size)
+    as_fatal (ngettext ("can't extend frag %lu char",
+			"can't extend frag %lu chars",
+			(unsigned long) header_size),
+	      (unsigned long) header_size);
+  fragS *last_newf = first_newf;
+  obstack_blank_fast (ob, header_size);
+  last_newf->fr_type = rs_fill;
+  last_newf->fr_fix = header_size;
+  char *header = last_newf->fr_literal;
+
+  /* Copy in the compressed data, adding new frags as necessary.  */
+  const char *contents = job->contents + header_size;
+  bfd_size_type left = compressed_size - header_size;
+  while (left > 0)
+    {
+      /* Fill all the space available in the current chunk.  If none
+	 is available, start a new frag.  */
+      int avail_out = obstack_room (ob);
       if (avail_out <= 0)
 	{
 	  fragS *newf;
@@ -1565,28 +1663,15 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
 	}
       if (avail_out <= 0)
 	as_fatal (_("can't extend frag"));
-      next_out = obstack_next_free (ob);
+      if ((bfd_size_type) avail_out > left)
+	avail_out = left;
+      memcpy (obstack_next_free (ob), contents, avail_out);
       obstack_blank_fast (ob, avail_out);
-      int x = compress_finish (use_zstd, ctx, &next_out, &avail_out, &out_size);
-      if (x < 0)
-	return;
-
-      last_newf->fr_fix += out_size;
-      compressed_size += out_size;
-
-      /* Return unused space.  */
-      if (avail_out > 0)
-	obstack_blank_fast (ob, -avail_out);
-
-      if (x == 0)
-	break;
+      last_newf->fr_fix += avail_out;
+      contents += avail_out;
+      left -= avail_out;
     }
 
-  /* PR binutils/18087: If compression didn't make the section smaller,
-     just keep it uncompressed.  */
-  if (compressed_size >= uncompressed_size)
-    return;
-
   /* Replace the uncompressed frag list with the compressed frag list.  */
   seginfo->frchainP->frch_root = first_newf;
   seginfo->frchainP->frch_last = last_newf;
@@ -1603,6 +1688,80 @@ compress_debug (bfd *abfd, asection *sec, void *xxx ATTRIBUTE_UNUSED)
     }
 }
 
+/* Compress the debug sections of ABFD.  Where the host supports
+   threads, the sections are compressed in parallel, one per processor
+   at a time.  */
+
+static void
+compress_debug_sections (bfd *abfd)
+{
+  struct compress_debug_jobs jobs;
+  bfd_size_type total_size = 0;
+  asection *sec;
+  unsigned int i;
+
+  jobs.count = 0;
+  for (sec = abfd->sections; sec != NULL; sec = sec->next)
+    if (compress_debug_p (sec))
+      jobs.count++;
+  if (jobs.count == 0)
+    return;
+
+  jobs.jobs = XCNEWVEC (struct compress_debug_job, jobs.count);
+  jobs.next = 0;
+  jobs.use_zstd = (abfd->flags & BFD_COMPRESS_ZSTD) != 0;
+  if ((abfd->flags & BFD_COMPRESS_GABI) == 0)
+    jobs.header_size = 12;
+  else
+    jobs.header_size = bfd_get_compression_header_size (abfd, NULL);
+  i = 0;
+  for (sec = abfd->sections; sec != NULL; sec = sec->next)
+    if (compress_debug_p (sec))
+      {
+	jobs.jobs[i++].sec = sec;
+	total_size += sec->size;
+      }
+
+#ifdef USE_THREADS
+  long nthreads = 0;
+  pthread_t *threads = NULL;
+
+  if (total_size >= COMPRESS_THREADS_MIN_SIZE)
+    {
+      nthreads = sysconf (_SC_NPROCESSORS_ONLN) - 1;
+      if (nthreads > (long) jobs.count - 1)
+	nthreads = (long) jobs.count - 1;
+    }
+  if (nthreads > 0)
+    threads = XNEWVEC (pthread_t, nthreads);
+
+  pthread_mutex_init (&jobs.lock, NULL);
+  long t;
+  for (t = 0; t < nthreads; t++)
+    if (pthread_create (&threads[t], NULL, compress_debug_worker, &jobs) != 0)
+      break;
+  nthreads = t;
+
+  /* This thread does its share of the work too, and all of it if no
+     threads could be started.  */
+  compress_debug_worker (&jobs);
+
+  for (t = 0; t < nthreads; t++)
+    pthread_join (threads[t], NULL);
+  pthread_mutex_destroy (&jobs.lock);
+  free (threads);
+#else
+  compress_debug_worker (&jobs);
+#endif
+
+  for (i = 0; i < jobs.count; i++)
+    {
+      install_compressed_debug (abfd, &jobs.jobs[i], jobs.header_size);
+      free (jobs.jobs[i].contents);
+    }
+  free (jobs.jobs);
+}
+
 #ifndef md_generate_nops
 /* Genenerate COUNT bytes of no-op instructions to WHERE.  A target
    backend must override this with proper no-op instructions.   */
@@ -2535,7 +2694,7 @@ write_object_file (void)
 	flags = BFD_COMPRESS | BFD_COMPRESS_GABI | BFD_COMPRESS_ZSTD;
       stdoutput->flags |= flags & bfd_applicable_file_flags (stdoutput);
       if ((stdoutput->flags & BFD_COMPRESS) != 0)
-	bfd_map_over_sections (stdoutput, compress_debug, (char *) 0);
+	compress_debug_sections (stdoutput);
     }
 
   bfd_map_over_sections (stdoutput, write_contents, (char *) 0);
@@ -41,6 +41,7 @@
 #include "gdbsupport/version.h"
 
 #include "floatformat.h"
+#include "memattr.h"
 
 #include "dis-asm.h"
 
@@ -1751,3 +1751,12 @@ extern void set_gdbarch_read_core_file_mappings (struct gdbarch *gdbarch, gdbarc
 typedef bool (gdbarch_use_target_description_from_corefile_notes_ftype) (struct gdbarch *gdbarch, struct bfd *corefile_bfd);
 extern bool gdbarch_use_target_description_from_corefile_notes (struct gdbarch *gdbarch, struct bfd *corefile_bfd);
 extern void set_gdbarch_use_target_description_from_corefile_notes (struct gdbarch *gdbarch, gdbarch_use_target_description_from_corefile_notes_ftype *use_target_description_from_corefile_notes);
+
+/* Return the memory map to use when the target does not supply one, e.g. the
+   flash, EEPROM and RAM layout of a microcontroller. */
+
+extern bool gdbarch_memory_map_p (struct gdbarch *gdbarch);
+
+typedef std::vector<mem_region> (gdbarch_memory_map_ftype) (struct gdbarch *gdbarch);
+extern std::vector<mem_region> gdbarch_memory_map (struct gdbarch *gdbarch);
+extern void set_gdbarch_memory_map (struct gdbarch *gdbarch, gdbarch_memory_map_ftype *memory_map);
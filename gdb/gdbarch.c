@@ -258,6 +258,7 @@ struct gdbarch
   gdbarch_get_pc_address_flags_ftype *get_pc_address_flags = default_get_pc_address_flags;
   gdbarch_read_core_file_mappings_ftype *read_core_file_mappings = default_read_core_file_mappings;
   gdbarch_use_target_description_from_corefile_notes_ftype *use_target_description_from_corefile_notes = default_use_target_description_from_corefile_notes;
+  gdbarch_memory_map_ftype *memory_map = nullptr;
 };
 
 /* Create a new ``struct gdbarch'' based on information provided by
@@ -527,6 +528,7 @@ verify_gdbarch (struct gdbarch *gdbarch)
   /* Skip verify of get_pc_address_flags, invalid_p == 0 */
   /* Skip verify of read_core_file_mappings, invalid_p == 0 */
   /* Skip verify of use_target_description_from_corefile_notes, invalid_p == 0 */
+  /* Skip verify of memory_map, has predicate.  */
   if (!log.empty ())
     internal_error (_("verify_gdbarch: the following are invalid ...%s"),
 		    log.c_str ());
@@ -1386,6 +1388,12 @@ gdbarch_dump (struct gdbarch *gdbarch, struct ui_file *file)
   gdb_printf (file,
 	      "gdbarch_dump: use_target_description_from_corefile_notes = <%s>\n",
 	      host_address_to_string (gdbarch->use_target_description_from_corefile_notes));
+  gdb_printf (file,
+	      "gdbarch_dump: gdbarch_memory_map_p() = %d\n",
+	      gdbarch_memory_map_p (gdbarch));
+  gdb_printf (file,
+	      "gdbarch_dump: memory_map = <%s>\n",
+	      host_address_to_string (gdbarch->memory_map));
   if (gdbarch->dump_tdep != NULL)
     gdbarch->dump_tdep (gdbarch, file);
 }
@@ -5463,3 +5471,27 @@ set_gdbarch_use_target_description_from_corefile_notes (struct gdbarch *gdbarch,
 {
   gdbarch->use_target_description_from_corefile_notes = use_target_description_from_corefile_notes;
 }
+
+bool
+gdbarch_memory_map_p (struct gdbarch *gdbarch)
+{
+  gdb_assert (gdbarch != NULL);
+  return gdbarch->memory_map != NULL;
+}
+
+std::vector<mem_region>
+gdbarch_memory_map (struct gdbarch *gdbarch)
+{
+  gdb_assert (gdbarch != NULL);
+  gdb_assert (gdbarch->memory_map != NULL);
+  if (gdbarch_debug >= 2)
+    gdb_printf (gdb_stdlog, "gdbarch_memory_map called\n");
+  return gdbarch->memory_map (gdbarch);
+}
+
+void
+set_gdbarch_memory_map (struct gdbarch *gdbarch,
+			gdbarch_memory_map_ftype memory_map)
+{
+  gdbarch->memory_map = memory_map;
+}
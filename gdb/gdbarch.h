@@ -53,6 +53,7 @@ struct stap_parse_info;
 struct expr_builder;
 struct ravenscar_arch_ops;
 struct mem_range;
+struct mem_region;
 struct syscalls_info;
 struct thread_info;
 struct ui_out;
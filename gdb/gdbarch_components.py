@@ -2778,3 +2778,14 @@ The corefile's bfd is passed through COREFILE_BFD.
     predefault="default_use_target_description_from_corefile_notes",
     invalid=False,
 )
+
+Method(
+    comment="""
+Return the memory map to use when the target does not supply one, e.g. the
+flash, EEPROM and RAM layout of a microcontroller.
+""",
+    type="std::vector<mem_region>",
+    name="memory_map",
+    params=[],
+    predicate=True,
+)
@@ -0,0 +1,473 @@
+/* STM8 peripheral register descriptions for GDB.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+
+#include "gdbcore.h"
+#include "observable.h"
+#include "stm8-periph.h"
+#include "target.h"
+#include "xml-support.h"
+#include <algorithm>
+
+/* Every device ever loaded.  Architectures keep pointers to the device
+   they were created for, so devices are never freed.  */
+static std::vector<std::unique_ptr<stm8_device>> stm8_devices;
+
+/* The device selected with "set stm8 device-file".  */
+static stm8_device *stm8_selected_device;
+
+/* See stm8-periph.h.  */
+
+stm8_device *
+stm8_current_device ()
+{
+  return stm8_selected_device;
+}
+
+/* See stm8-periph.h.  */
+
+const stm8_periph_register *
+stm8_device::lookup (CORE_ADDR addr) const
+{
+  auto it = by_address.find (addr);
+
+  if (it == by_address.end ())
+    return nullptr;
+
+  return &registers[it->second];
+}
+
+/* See stm8-periph.h.  */
+
+bool
+stm8_device::read_register (int index, gdb_byte *buf)
+{
+  const stm8_periph_register &reg = registers[index];
+
+  if (reg.side_effects)
+    return target_read_memory (reg.addr, buf, reg.size) == 0;
+
+  stm8_periph_block &block = blocks[reg.block];
+
+  if (!block.valid)
+    {
+      /* Fetch the whole peripheral at once; the other registers shown by
+         the same "info registers" come from the cache.  */
+      for (const auto &span : block.spans)
+        if (target_read_memory (span.first,
+                                &block.contents[span.first - block.base],
+                                span.second)
+            != 0)
+          return false;
+
+      block.valid = true;
+    }
+
+  memcpy (buf, &block.contents[reg.addr - block.base], reg.size);
+  return true;
+}
+
+/* See stm8-periph.h.  */
+
+void
+stm8_device::write_register (int index, const gdb_byte *buf)
+{
+  const stm8_periph_register &reg = registers[index];
+
+  write_memory (reg.addr, buf, reg.size);
+
+  /* Writing a register may change others in the same peripheral (status
+     flags, shadow registers), so drop the whole block.  */
+  blocks[reg.block].valid = false;
+}
+
+/* See stm8-periph.h.  */
+
+void
+stm8_device::invalidate ()
+{
+  for (stm8_periph_block &block : blocks)
+    block.valid = false;
+}
+
+/* See stm8-periph.h.  */
+
+void
+stm8_device::invalidate (CORE_ADDR addr, ULONGEST len)
+{
+  /* Small writes, the common case, are resolved through the address
+     table; anything bigger just checks each peripheral window.  */
+  if (len <= 4)
+    {
+      for (ULONGEST i = 0; i < len; i++)
+        {
+          const stm8_periph_register *reg = lookup (addr + i);
+
+          if (reg != nullptr)
+            blocks[reg->block].valid = false;
+        }
+      return;
+    }
+
+  for (stm8_periph_block &block : blocks)
+    if (addr < block.base + block.size && block.base < addr + len)
+      block.valid = false;
+}
+
+static void
+stm8_periph_invalidate_all ()
+{
+  for (auto &device : stm8_devices)
+    device->invalidate ();
+}
+
+static void
+stm8_periph_target_resumed (ptid_t ptid)
+{
+  stm8_periph_invalidate_all ();
+}
+
+static void
+stm8_periph_target_changed (struct target_ops *target)
+{
+  stm8_periph_invalidate_all ();
+}
+
+static void
+stm8_periph_memory_changed (struct inferior *inf, CORE_ADDR addr, ssize_t len,
+                            const bfd_byte *data)
+{
+  for (auto &device : stm8_devices)
+    device->invalidate (addr, len);
+}
+
+/* Sort the registers of DEVICE into their peripherals, build the address
+   table and the read spans.  */
+
+static void
+stm8_finish_device (stm8_device *device)
+{
+  for (stm8_periph_block &block : device->blocks)
+    {
+      std::vector<const stm8_periph_register *> regs;
+
+      for (const stm8_periph_register &reg : device->registers)
+        if (&device->blocks[reg.block] == &block)
+          regs.push_back (&reg);
+
+      std::sort (regs.begin (), regs.end (),
+                 [] (const stm8_periph_register *a,
+                     const stm8_periph_register *b)
+                 { return a->addr < b->addr; });
+
+      if (block.size == 0 && !regs.empty ())
+        block.size = regs.back ()->addr + regs.back ()->size - block.base;
+
+      /* Coalesce runs of plain registers, gaps included, into one read;
+         a register with read side effects ends the current span.  */
+      CORE_ADDR start = 0, end = 0;
+      bool open = false;
+
+      for (const stm8_periph_register *reg : regs)
+        {
+          if (reg->side_effects)
+            {
+              if (open)
+                block.spans.emplace_back (start, end - start);
+              open = false;
+              continue;
+            }
+
+          if (!open)
+            {
+              start = reg->addr;
+              open = true;
+            }
+          end = std::max (end, (CORE_ADDR)(reg->addr + reg->size));
+        }
+      if (open)
+        block.spans.emplace_back (start, end - start);
+
+      block.contents.resize (block.size);
+    }
+
+  for (size_t i = 0; i < device->registers.size (); i++)
+    {
+      const stm8_periph_register &reg = device->registers[i];
+
+      for (int j = 0; j < reg.size; j++)
+        if (!device->by_address.emplace (reg.addr + j, i).second)
+          error (_ ("Register \"%s\" overlaps register \"%s\""),
+                 reg.name.c_str (),
+                 device->registers[device->by_address[reg.addr + j]]
+                     .name.c_str ());
+    }
+}
+
+#if !defined(HAVE_LIBEXPAT)
+
+static std::unique_ptr<stm8_device>
+stm8_parse_device_file (const char *filename)
+{
+  error (_ ("Can not parse STM8 device file; XML support was disabled "
+            "at compile time"));
+}
+
+#else /* HAVE_LIBEXPAT */
+
+/* Internal parsing data passed to all XML callbacks.  */
+
+struct stm8_device_parsing_data
+{
+  stm8_device *device;
+};
+
+/* Handle the start of a <device> element.  */
+
+static void
+stm8_device_start_device (struct gdb_xml_parser *parser,
+                          const struct gdb_xml_element *element,
+                          void *user_data,
+                          std::vector<gdb_xml_value> &attributes)
+{
+  auto *data = (struct stm8_device_parsing_data *)user_data;
+  struct gdb_xml_value *attr = xml_find_attribute (attributes, "name");
+
+  if (attr != nullptr)
+    data->device->name = (const char *)attr->value.get ();
+}
+
+/* Handle the start of a <peripheral> element.  */
+
+static void
+stm8_device_start_peripheral (struct gdb_xml_parser *parser,
+                              const struct gdb_xml_element *element,
+                              void *user_data,
+                              std::vector<gdb_xml_value> &attributes)
+{
+  auto *data = (struct stm8_device_parsing_data *)user_data;
+  struct gdb_xml_value *attr;
+  stm8_periph_block block;
+
+  block.name = (const char *)xml_find_attribute (attributes, "name")
+                   ->value.get ();
+  block.base
+      = *(ULONGEST *)xml_find_attribute (attributes, "base")->value.get ();
+  block.size = 0;
+
+  attr = xml_find_attribute (attributes, "size");
+  if (attr != nullptr)
+    block.size = *(ULONGEST *)attr->value.get ();
+
+  data->device->blocks.push_back (std::move (block));
+}
+
+/* Handle the start of a <register> element.  */
+
+static void
+stm8_device_start_register (struct gdb_xml_parser *parser,
+                            const struct gdb_xml_element *element,
+                            void *user_data,
+                            std::vector<gdb_xml_value> &attributes)
+{
+  auto *data = (struct stm8_device_parsing_data *)user_data;
+  const stm8_periph_block &block = data->device->blocks.back ();
+  struct gdb_xml_value *attr;
+  stm8_periph_register reg;
+
+  reg.name = (const char *)xml_find_attribute (attributes, "name")
+                 ->value.get ();
+  reg.addr = block.base
+             + *(ULONGEST *)xml_find_attribute (attributes, "offset")
+                    ->value.get ();
+  reg.block = data->device->blocks.size () - 1;
+
+  reg.size = 1;
+  attr = xml_find_attribute (attributes, "size");
+  if (attr != nullptr)
+    reg.size = *(ULONGEST *)attr->value.get ();
+  if (reg.size != 1 && reg.size != 2 && reg.size != 4)
+    gdb_xml_error (parser, _ ("Register \"%s\" has unsupported size %d"),
+                   reg.name.c_str (), reg.size);
+
+  if (block.size != 0 && reg.addr + reg.size > block.base + block.size)
+    gdb_xml_error (parser, _ ("Register \"%s\" lies outside of \"%s\""),
+                   reg.name.c_str (), block.name.c_str ());
+
+  reg.side_effects = false;
+  attr = xml_find_attribute (attributes, "side-effects");
+  if (attr != nullptr)
+    reg.side_effects = *(ULONGEST *)attr->value.get () != 0;
+
+  for (const stm8_periph_register &other : data->device->registers)
+    if (other.name == reg.name)
+      gdb_xml_error (parser, _ ("Register \"%s\" is defined twice"),
+                     reg.name.c_str ());
+
+  data->device->registers.push_back (std::move (reg));
+}
+
+/* Handle the start of a <field> element.  */
+
+static void
+stm8_device_start_field (struct gdb_xml_parser *parser,
+                         const struct gdb_xml_element *element,
+                         void *user_data,
+                         std::vector<gdb_xml_value> &attributes)
+{
+  auto *data = (struct stm8_device_parsing_data *)user_data;
+  stm8_periph_register &reg = data->device->registers.back ();
+  struct gdb_xml_value *attr;
+  stm8_periph_field field;
+
+  field.name = (const char *)xml_find_attribute (attributes, "name")
+                   ->value.get ();
+  field.start
+      = *(ULONGEST *)xml_find_attribute (attributes, "start")->value.get ();
+  field.end = field.start;
+
+  attr = xml_find_attribute (attributes, "end");
+  if (attr != nullptr)
+    field.end = *(ULONGEST *)attr->value.get ();
+
+  if (field.end < field.start || field.end >= reg.size * TARGET_CHAR_BIT)
+    gdb_xml_error (parser, _ ("Bad bit range for field \"%s\" of \"%s\""),
+                   field.name.c_str (), reg.name.c_str ());
+
+  reg.fields.push_back (std::move (field));
+}
+
+/* The allowed elements and attributes for an STM8 device file.  */
+
+static const struct gdb_xml_enum stm8_yes_no_enum[] = {
+  { "yes", 1 },
+  { "no", 0 },
+  { NULL, 0 }
+};
+
+static const struct gdb_xml_attribute field_attributes[] = {
+  { "name", GDB_XML_AF_NONE, NULL, NULL },
+  { "start", GDB_XML_AF_NONE, gdb_xml_parse_attr_ulongest, NULL },
+  { "end", GDB_XML_AF_OPTIONAL, gdb_xml_parse_attr_ulongest, NULL },
+  { NULL, GDB_XML_AF_NONE, NULL, NULL }
+};
+
+static const struct gdb_xml_element register_children[] = {
+  { "field", field_attributes, NULL,
+    GDB_XML_EF_REPEATABLE | GDB_XML_EF_OPTIONAL, stm8_device_start_field,
+    NULL },
+  { NULL, NULL, NULL, GDB_XML_EF_NONE, NULL, NULL }
+};
+
+static const struct gdb_xml_attribute register_attributes[] = {
+  { "name", GDB_XML_AF_NONE, NULL, NULL },
+  { "offset", GDB_XML_AF_NONE, gdb_xml_parse_attr_ulongest, NULL },
+  { "size", GDB_XML_AF_OPTIONAL, gdb_xml_parse_attr_ulongest, NULL },
+  { "side-effects", GDB_XML_AF_OPTIONAL, gdb_xml_parse_attr_enum,
+    &stm8_yes_no_enum },
+  { NULL, GDB_XML_AF_NONE, NULL, NULL }
+};
+
+static const struct gdb_xml_element peripheral_children[] = {
+  { "register", register_attributes, register_children,
+    GDB_XML_EF_REPEATABLE | GDB_XML_EF_OPTIONAL, stm8_device_start_register,
+    NULL },
+  { NULL, NULL, NULL, GDB_XML_EF_NONE, NULL, NULL }
+};
+
+static const struct gdb_xml_attribute peripheral_attributes[] = {
+  { "name", GDB_XML_AF_NONE, NULL, NULL },
+  { "base", GDB_XML_AF_NONE, gdb_xml_parse_attr_ulongest, NULL },
+  { "size", GDB_XML_AF_OPTIONAL, gdb_xml_parse_attr_ulongest, NULL },
+  { NULL, GDB_XML_AF_NONE, NULL, NULL }
+};
+
+static const struct gdb_xml_element device_children[] = {
+  { "peripheral", peripheral_attributes, peripheral_children,
+    GDB_XML_EF_REPEATABLE | GDB_XML_EF_OPTIONAL, stm8_device_start_peripheral,
+    NULL },
+  { NULL, NULL, NULL, GDB_XML_EF_NONE, NULL, NULL }
+};
+
+static const struct gdb_xml_attribute device_attributes[] = {
+  { "name", GDB_XML_AF_OPTIONAL, NULL, NULL },
+  { NULL, GDB_XML_AF_NONE, NULL, NULL }
+};
+
+static const struct gdb_xml_element device_elements[] = {
+  { "device", device_attributes, device_children, GDB_XML_EF_NONE,
+    stm8_device_start_device, NULL },
+  { NULL, NULL, NULL, GDB_XML_EF_NONE, NULL, NULL }
+};
+
+static std::unique_ptr<stm8_device>
+stm8_parse_device_file (const char *filename)
+{
+  std::optional<gdb::char_vector> text
+      = xml_fetch_content_from_file (filename, NULL);
+
+  if (!text)
+    error (_ ("Could not open \"%s\""), filename);
+
+  std::unique_ptr<stm8_device> device (new stm8_device);
+  stm8_device_parsing_data data { device.get () };
+
+  device->filename = filename;
+
+  if (gdb_xml_parse_quick (_ ("STM8 device file"), NULL, device_elements,
+                           text->data (), &data)
+      != 0)
+    error (_ ("Could not parse STM8 device file \"%s\""), filename);
+
+  return device;
+}
+
+#endif /* HAVE_LIBEXPAT */
+
+/* See stm8-periph.h.  */
+
+void
+stm8_select_device_file (const char *filename)
+{
+  if (filename == nullptr || *filename == '\0')
+    {
+      stm8_selected_device = nullptr;
+      return;
+    }
+
+  std::unique_ptr<stm8_device> device = stm8_parse_device_file (filename);
+
+  stm8_finish_device (device.get ());
+
+  stm8_devices.push_back (std::move (device));
+  stm8_selected_device = stm8_devices.back ().get ();
+}
+
+void _initialize_stm8_periph ();
+void
+_initialize_stm8_periph ()
+{
+  gdb::observers::target_resumed.attach (stm8_periph_target_resumed,
+                                         "stm8-periph");
+  gdb::observers::target_changed.attach (stm8_periph_target_changed,
+                                         "stm8-periph");
+  gdb::observers::memory_changed.attach (stm8_periph_memory_changed,
+                                         "stm8-periph");
+}
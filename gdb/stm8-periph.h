@@ -0,0 +1,121 @@
+/* STM8 peripheral register descriptions for GDB.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef STM8_PERIPH_H
+#define STM8_PERIPH_H
+
+#include "gdbsupport/byte-vector.h"
+#include <unordered_map>
+
+/* A device file describes the memory-mapped peripheral registers of one
+   STM8 part, in the spirit of CMSIS SVD files:
+
+     <device name="stm8s103f3">
+       <peripheral name="UART1" base="0x5230">
+         <register name="UART1_SR" offset="0" size="1">
+           <field name="TXE" start="7"/>
+           <field name="TC" start="6"/>
+         </register>
+         <register name="UART1_DR" offset="1" side-effects="yes"/>
+       </peripheral>
+     </device>
+
+   Registers become pseudo registers of the STM8 architecture and the
+   fields are shown like the CC flags.  Registers whose read has side
+   effects (data registers, status clears) are only read on request and
+   never as part of a batched peripheral read.  */
+
+/* A bitfield of a peripheral register.  */
+
+struct stm8_periph_field
+{
+  std::string name;
+  int start;
+  int end;
+};
+
+/* A memory-mapped peripheral register.  */
+
+struct stm8_periph_register
+{
+  std::string name;
+  CORE_ADDR addr;
+  int size;
+  bool side_effects;
+  /* Index of the peripheral this register belongs to.  */
+  int block;
+  std::vector<stm8_periph_field> fields;
+};
+
+/* A peripheral: a window of registers fetched together.  */
+
+struct stm8_periph_block
+{
+  std::string name;
+  CORE_ADDR base;
+  ULONGEST size;
+  /* Address ranges read with one memory access each.  These cover all
+     registers of the block except those with read side effects.  */
+  std::vector<std::pair<CORE_ADDR, ULONGEST>> spans;
+  /* Block contents as last read from the target, if VALID.  */
+  gdb::byte_vector contents;
+  bool valid = false;
+};
+
+/* A loaded device file.  */
+
+struct stm8_device
+{
+  std::string name;
+  std::string filename;
+  std::vector<stm8_periph_block> blocks;
+  std::vector<stm8_periph_register> registers;
+  /* Map from each byte address covered by a register to its index in
+     REGISTERS.  */
+  std::unordered_map<CORE_ADDR, int> by_address;
+
+  /* Return the register covering ADDR, or NULL.  */
+  const stm8_periph_register *lookup (CORE_ADDR addr) const;
+
+  /* Read register INDEX into BUF, fetching its peripheral block first if
+     needed.  Return false if the target memory could not be read.  */
+  bool read_register (int index, gdb_byte *buf);
+
+  /* Write BUF to register INDEX.  */
+  void write_register (int index, const gdb_byte *buf);
+
+  /* Forget all cached peripheral contents.  */
+  void invalidate ();
+
+  /* Forget cached contents of the peripherals overlapping ADDR..ADDR+LEN.  */
+  void invalidate (CORE_ADDR addr, ULONGEST len);
+};
+
+/* Return the device selected with "set stm8 device-file", or NULL.  The
+   returned object lives until GDB exits.  */
+
+extern stm8_device *stm8_current_device ();
+
+/* Parse FILENAME and make it the current device, or drop the current
+   device if FILENAME is NULL or empty.  Throws an error if the file
+   cannot be read or parsed, leaving the current device unchanged.  */
+
+extern void stm8_select_device_file (const char *filename);
+
+#endif /* STM8_PERIPH_H */
@@ -24,7 +24,9 @@
 #include "arch-utils.h"
 #include "defs.h"
 #include "dis-asm.h"
+#include "disasm.h"
 #include "dwarf2/frame.h"
+#include "elf-bfd.h"
 #include "frame-base.h"
 #include "frame-unwind.h"
 #include "frame.h"
@@ -33,14 +35,19 @@
 #include "gdbsupport/common-debug.h"
 #include "gdbtypes.h"
 #include "inferior.h"
+#include "memattr.h"
+#include "observable.h"
 #include "objfiles.h"
 #include "progspace.h"
 #include "regcache.h"
+#include "reggroups.h"
+#include "stm8-periph.h"
 #include "symfile.h"
 #include <regcache.h>
 #include "target-descriptions.h"
 #include "trad-frame.h"
 #include <algorithm>
+#include <unordered_map>
 
 enum stm8_regnum
 {
@@ -73,6 +80,10 @@ unsigned int stm8_debug = 0;
 
 #define STM8_NUM_REGS ARRAY_SIZE (stm8_register_names)
 
+/* Peripheral registers from the device file follow the pseudo registers
+   above.  */
+#define STM8_FIRST_PERIPH_REGNUM (STM8_NUM_REGS + STM8_NUM_PSEUDOREGS)
+
 struct stm8_gdbarch_tdep : gdbarch_tdep_base
 {
   enum stm8_producer producer;
@@ -82,6 +93,16 @@ struct stm8_gdbarch_tdep : gdbarch_tdep_base
   struct type *func_void_type;
   /* Type for a pointer to a function.  Used for the type of PC.  */
   struct type *pc_type;
+
+  /* Device whose peripheral registers this architecture shows, or
+     NULL.  */
+  stm8_device *device;
+  /* Register types of the peripheral registers, indexed like
+     DEVICE->registers.  */
+  std::vector<struct type *> periph_types;
+  /* Group of all peripheral registers, and one group per peripheral.  */
+  const reggroup *periph_reggroup;
+  std::vector<const reggroup *> block_reggroups;
 };
 
 enum insn_return_kind
@@ -157,12 +178,37 @@ stm8_initialize_soft_register_info (struct stm8_gdbarch_tdep *tdep)
   tdep->producer = stm8_get_producer ();
 }
 
+/* Return the index of peripheral register REGNUM in the device of
+   GDBARCH, or -1 if REGNUM is not a peripheral register.  */
+
+static int
+stm8_periph_index (struct gdbarch *gdbarch, int regnum)
+{
+  stm8_gdbarch_tdep *tdep = gdbarch_tdep<stm8_gdbarch_tdep> (gdbarch);
+
+  if (tdep->device == nullptr || regnum < STM8_FIRST_PERIPH_REGNUM)
+    return -1;
+
+  if ((size_t)(regnum - STM8_FIRST_PERIPH_REGNUM)
+      >= tdep->device->registers.size ())
+    return -1;
+
+  return regnum - STM8_FIRST_PERIPH_REGNUM;
+}
+
 static const char *
 stm8_register_name (struct gdbarch *gdbarch, int regnum)
 {
   if (regnum >= 0 && regnum < STM8_NUM_REGS)
     return stm8_register_names[regnum];
 
+  int periph = stm8_periph_index (gdbarch, regnum);
+  if (periph >= 0)
+    {
+      stm8_gdbarch_tdep *tdep = gdbarch_tdep<stm8_gdbarch_tdep> (gdbarch);
+      return tdep->device->registers[periph].name.c_str ();
+    }
+
   if (stm8_get_producer () == SDCC_PRODUCER)
     {
       switch (regnum)
@@ -183,6 +229,13 @@ stm8_register_name (struct gdbarch *gdbarch, int regnum)
 static struct type *
 stm8_register_type (struct gdbarch *gdbarch, int regnum)
 {
+  int periph = stm8_periph_index (gdbarch, regnum);
+  if (periph >= 0)
+    {
+      stm8_gdbarch_tdep *tdep = gdbarch_tdep<stm8_gdbarch_tdep> (gdbarch);
+      return tdep->periph_types[periph];
+    }
+
   switch (regnum)
     {
     case STM8_PC_REGNUM:
@@ -205,6 +258,15 @@ stm8_pseudo_register_read (struct gdbarch *gdbarch,
   enum register_status status;
   gdb_byte tmp[4];
 
+  int periph = stm8_periph_index (gdbarch, regnum);
+  if (periph >= 0)
+    {
+      stm8_gdbarch_tdep *tdep = gdbarch_tdep<stm8_gdbarch_tdep> (gdbarch);
+      if (!tdep->device->read_register (periph, buf))
+        return REG_UNAVAILABLE;
+      return REG_VALID;
+    }
+
   switch (regnum)
     {
     case STM8_XH_REGNUM:
@@ -252,6 +314,14 @@ stm8_pseudo_register_write (struct gdbarch *gdbarch, struct regcache *regcache,
   enum register_status status;
   gdb_byte tmp[4];
 
+  int periph = stm8_periph_index (gdbarch, regnum);
+  if (periph >= 0)
+    {
+      stm8_gdbarch_tdep *tdep = gdbarch_tdep<stm8_gdbarch_tdep> (gdbarch);
+      tdep->device->write_register (periph, buf);
+      return;
+    }
+
   switch (regnum)
     {
 
@@ -301,6 +371,79 @@ stm8_pseudo_register_write (struct gdbarch *gdbarch, struct regcache *regcache,
     }
 }
 
+/* Implement the "register_reggroup_p" gdbarch method.  Peripheral
+   registers only show up in their own groups and "all"; in particular they
+   are never saved and restored around inferior calls.  Registers whose
+   read has side effects are left out of "all" too, so that "info
+   all-registers" does not clear a status flag or consume a received
+   byte.  */
+
+static int
+stm8_register_reggroup_p (struct gdbarch *gdbarch, int regnum,
+                          const struct reggroup *group)
+{
+  int periph = stm8_periph_index (gdbarch, regnum);
+
+  if (periph < 0)
+    return default_register_reggroup_p (gdbarch, regnum, group);
+
+  stm8_gdbarch_tdep *tdep = gdbarch_tdep<stm8_gdbarch_tdep> (gdbarch);
+  const stm8_periph_register &reg = tdep->device->registers[periph];
+
+  if (group == all_reggroup)
+    return !reg.side_effects;
+
+  return (group == tdep->periph_reggroup
+          || group == tdep->block_reggroups[reg.block]);
+}
+
+/* Create the register types and groups for the peripheral registers of
+   TDEP->device.  */
+
+static void
+stm8_init_periph_registers (struct gdbarch *gdbarch,
+                            stm8_gdbarch_tdep *tdep)
+{
+  const struct builtin_type *bt = builtin_type (gdbarch);
+
+  tdep->periph_reggroup
+      = reggroup_gdbarch_new (gdbarch, "peripheral", USER_REGGROUP);
+  reggroup_add (gdbarch, tdep->periph_reggroup);
+
+  for (const stm8_periph_block &block : tdep->device->blocks)
+    {
+      const reggroup *group = reggroup_gdbarch_new (
+          gdbarch, block.name.c_str (), USER_REGGROUP);
+
+      reggroup_add (gdbarch, group);
+      tdep->block_reggroups.push_back (group);
+    }
+
+  for (const stm8_periph_register &reg : tdep->device->registers)
+    {
+      struct type *type;
+
+      if (reg.fields.empty ())
+        type = (reg.size == 1   ? bt->builtin_uint8
+                : reg.size == 2 ? bt->builtin_uint16
+                                : bt->builtin_uint32);
+      else
+        {
+          type = arch_flags_type (gdbarch, reg.name.c_str (),
+                                  reg.size * TARGET_CHAR_BIT);
+          for (const stm8_periph_field &field : reg.fields)
+            if (field.start == field.end)
+              append_flags_type_flag (type, field.start, field.name.c_str ());
+            else
+              append_flags_type_field (type, field.start,
+                                       field.end - field.start + 1,
+                                       bt->builtin_uint8, field.name.c_str ());
+        }
+
+      tdep->periph_types.push_back (type);
+    }
+}
+
 struct stm8_frame_cache
 {
   /* Base address.  */
@@ -858,6 +1001,550 @@ stm8_return_value (struct gdbarch *gdbarch, struct value *function,
     }
 }
 
+/* The disassembler symbol index of a program space, over the symbols
+   of all of its objfiles, and the symbol tables it points into.  */
+
+struct stm8_pspace_symbols
+{
+  struct stm8_symbol_index *index = nullptr;
+  std::vector<gdb::unique_xmalloc_ptr<asymbol *>> symbol_tables;
+
+  ~stm8_pspace_symbols ()
+  {
+    stm8_symbol_index_free (index);
+  }
+};
+
+static const registry<program_space>::key<stm8_pspace_symbols>
+    stm8_symbol_index_key;
+
+/* Return the disassembler symbol index of PSPACE, building it from the
+   BFD symbol tables of its objfiles on first use.  */
+
+static const struct stm8_symbol_index *
+stm8_pspace_symbol_index (program_space *pspace)
+{
+  stm8_pspace_symbols *data = stm8_symbol_index_key.get (pspace);
+
+  if (data != nullptr)
+    return data->index;
+
+  data = stm8_symbol_index_key.emplace (pspace);
+
+  std::vector<asymbol *> symbols;
+  for (objfile *objfile : pspace->objfiles ())
+    {
+      bfd *abfd = objfile->obfd.get ();
+
+      if (abfd == nullptr || (bfd_get_file_flags (abfd) & HAS_SYMS) == 0)
+        continue;
+
+      long storage_needed = bfd_get_symtab_upper_bound (abfd);
+      if (storage_needed <= 0)
+        continue;
+
+      gdb::unique_xmalloc_ptr<asymbol *> symbol_table (
+          (asymbol **)xmalloc (storage_needed));
+      long count = bfd_canonicalize_symtab (abfd, symbol_table.get ());
+      if (count <= 0)
+        continue;
+
+      symbols.insert (symbols.end (), symbol_table.get (),
+                      symbol_table.get () + count);
+      data->symbol_tables.push_back (std::move (symbol_table));
+    }
+
+  data->index = stm8_symbol_index_create (symbols.data (), symbols.size ());
+
+  stm8_debug_printf ("stm8_pspace_symbol_index: %zu symbols indexed\n",
+                     symbols.size ());
+
+  return data->index;
+}
+
+/* Drop the symbol index of the program space of OBJFILE when objfiles
+   come or go.  */
+
+static void
+stm8_symbol_index_objfiles_changed (struct objfile *objfile)
+{
+  stm8_symbol_index_key.clear (objfile->pspace);
+}
+
+/* One piece of disassembler output: text printed through the stream
+   callbacks, or an address handed to print_address_func.  */
+
+struct stm8_insn_piece
+{
+  enum
+  {
+    TEXT,
+    STYLED_TEXT,
+    ADDRESS
+  } kind;
+  enum disassembler_style style;
+  std::string text;
+  bfd_vma addr;
+};
+
+/* A decoded instruction, kept so it can be printed again without reading
+   target memory or decoding it a second time.  */
+
+struct stm8_cached_insn
+{
+  int length;
+  std::vector<stm8_insn_piece> pieces;
+};
+
+/* Disassembly of the read-only code of an objfile, by address.  */
+
+struct stm8_insn_cache
+{
+  std::unordered_map<CORE_ADDR, stm8_cached_insn> insns;
+
+  /* Drop every instruction that overlaps ADDR..ADDR+LEN.  */
+  void invalidate (CORE_ADDR addr, ULONGEST len);
+};
+
+/* Longest STM8 instruction, prefix included.  */
+
+static const int STM8_MAX_INSN_LENGTH = 5;
+
+/* Most instructions kept for one objfile.  A full cache is emptied and
+   filled again from scratch.  */
+
+static const size_t STM8_INSN_CACHE_MAX = 65536;
+
+void
+stm8_insn_cache::invalidate (CORE_ADDR addr, ULONGEST len)
+{
+  if (insns.empty ())
+    return;
+
+  /* Probing each possible start address is cheaper than a walk over the
+     whole table, unless the range is large.  */
+  if (len > insns.size ())
+    {
+      for (auto it = insns.begin (); it != insns.end ();)
+        if (it->first < addr + len && it->first + it->second.length > addr)
+          it = insns.erase (it);
+        else
+          ++it;
+      return;
+    }
+
+  CORE_ADDR lo = addr > STM8_MAX_INSN_LENGTH - 1
+                     ? addr - (STM8_MAX_INSN_LENGTH - 1)
+                     : 0;
+  for (CORE_ADDR pc = lo; pc < addr + len; pc++)
+    {
+      auto it = insns.find (pc);
+      if (it != insns.end () && pc + it->second.length > addr)
+        insns.erase (it);
+    }
+}
+
+static const registry<objfile>::key<stm8_insn_cache> stm8_insn_cache_key;
+
+/* Whether to cache the disassembly of read-only code.  */
+
+static bool stm8_disassembly_cache = true;
+
+/* Return the instruction cache covering MEMADDR, or NULL if the address
+   is not in a read-only section of an objfile.  */
+
+static stm8_insn_cache *
+stm8_find_insn_cache (CORE_ADDR memaddr)
+{
+  if (!stm8_disassembly_cache)
+    return nullptr;
+
+  struct obj_section *osect = find_pc_section (memaddr);
+  if (osect == nullptr)
+    return nullptr;
+
+  flagword flags = bfd_section_flags (osect->the_bfd_section);
+  if ((flags & (SEC_READONLY | SEC_HAS_CONTENTS))
+      != (SEC_READONLY | SEC_HAS_CONTENTS))
+    return nullptr;
+
+  stm8_insn_cache *cache = stm8_insn_cache_key.get (osect->objfile);
+  if (cache == nullptr)
+    cache = stm8_insn_cache_key.emplace (osect->objfile);
+  return cache;
+}
+
+/* Drop cached instructions overlapping ADDR..ADDR+LEN in every objfile of
+   the current program space.  */
+
+static void
+stm8_invalidate_insn_caches (CORE_ADDR addr, ULONGEST len)
+{
+  if (current_program_space == nullptr)
+    return;
+
+  for (objfile *objfile : current_program_space->objfiles ())
+    {
+      stm8_insn_cache *cache = stm8_insn_cache_key.get (objfile);
+      if (cache != nullptr)
+        cache->invalidate (addr, len);
+    }
+}
+
+/* Drop all cached instructions of the current program space.  */
+
+static void
+stm8_clear_insn_caches ()
+{
+  if (current_program_space == nullptr)
+    return;
+
+  for (objfile *objfile : current_program_space->objfiles ())
+    stm8_insn_cache_key.clear (objfile);
+}
+
+static void
+stm8_insn_cache_memory_changed (struct inferior *inf, CORE_ADDR addr,
+                                ssize_t len, const bfd_byte *data)
+{
+  stm8_invalidate_insn_caches (addr, len);
+}
+
+/* Writes to registers or memory that bypass memory_changed, and "load",
+   which rewrites the program without creating a new objfile when the
+   same file is loaded again, come here.  */
+
+static void
+stm8_insn_cache_target_changed (struct target_ops *target)
+{
+  stm8_clear_insn_caches ();
+}
+
+static void
+stm8_insn_cache_inferior_created (inferior *inf)
+{
+  stm8_clear_insn_caches ();
+}
+
+/* Drop the caches when new code may have come with a new objfile.  */
+
+static void
+stm8_insn_cache_new_objfile (struct objfile *objfile)
+{
+  stm8_clear_insn_caches ();
+}
+
+/* State of a disassembly being recorded into the instruction cache.  The
+   caller's stream and callbacks are saved here and the recording ones put
+   in their place.  */
+
+struct stm8_insn_recorder
+{
+  disassemble_info *info;
+  void *stream;
+  fprintf_ftype fprintf_func;
+  fprintf_styled_ftype fprintf_styled_func;
+  void (*print_address_func) (bfd_vma, struct disassemble_info *);
+  stm8_cached_insn insn;
+
+  explicit stm8_insn_recorder (disassemble_info *info_);
+  ~stm8_insn_recorder ();
+
+  DISABLE_COPY_AND_ASSIGN (stm8_insn_recorder);
+};
+
+static int ATTRIBUTE_PRINTF (2, 3)
+stm8_record_fprintf (void *stream, const char *fmt, ...)
+{
+  stm8_insn_recorder *rec = (stm8_insn_recorder *)stream;
+  va_list args;
+
+  va_start (args, fmt);
+  std::string text = string_vprintf (fmt, args);
+  va_end (args);
+
+  rec->fprintf_func (rec->stream, "%s", text.c_str ());
+  rec->insn.pieces.push_back (
+      { stm8_insn_piece::TEXT, dis_style_text, std::move (text), 0 });
+  return 0;
+}
+
+static int ATTRIBUTE_PRINTF (3, 4)
+stm8_record_fprintf_styled (void *stream, enum disassembler_style style,
+                            const char *fmt, ...)
+{
+  stm8_insn_recorder *rec = (stm8_insn_recorder *)stream;
+  va_list args;
+
+  va_start (args, fmt);
+  std::string text = string_vprintf (fmt, args);
+  va_end (args);
+
+  rec->fprintf_styled_func (rec->stream, style, "%s", text.c_str ());
+  rec->insn.pieces.push_back (
+      { stm8_insn_piece::STYLED_TEXT, style, std::move (text), 0 });
+  return 0;
+}
+
+static void
+stm8_record_print_address (bfd_vma addr, struct disassemble_info *info)
+{
+  stm8_insn_recorder *rec = (stm8_insn_recorder *)info->stream;
+
+  /* The address is printed by GDB itself, with the symbol context of the
+     moment, so only the address is recorded.  */
+  info->stream = rec->stream;
+  rec->print_address_func (addr, info);
+  info->stream = rec;
+  rec->insn.pieces.push_back (
+      { stm8_insn_piece::ADDRESS, dis_style_address, std::string (), addr });
+}
+
+stm8_insn_recorder::stm8_insn_recorder (disassemble_info *info_)
+    : info (info_), stream (info_->stream),
+      fprintf_func (info_->fprintf_func),
+      fprintf_styled_func (info_->fprintf_styled_func),
+      print_address_func (info_->print_address_func)
+{
+  info->stream = this;
+  info->fprintf_func = stm8_record_fprintf;
+  info->fprintf_styled_func = stm8_record_fprintf_styled;
+  info->print_address_func = stm8_record_print_address;
+}
+
+stm8_insn_recorder::~stm8_insn_recorder ()
+{
+  info->stream = stream;
+  info->fprintf_func = fprintf_func;
+  info->fprintf_styled_func = fprintf_styled_func;
+  info->print_address_func = print_address_func;
+}
+
+/* Print the cached instruction INSN through INFO.  */
+
+static int
+stm8_replay_insn (const stm8_cached_insn &insn, disassemble_info *info)
+{
+  for (const stm8_insn_piece &piece : insn.pieces)
+    switch (piece.kind)
+      {
+      case stm8_insn_piece::TEXT:
+        info->fprintf_func (info->stream, "%s", piece.text.c_str ());
+        break;
+      case stm8_insn_piece::STYLED_TEXT:
+        info->fprintf_styled_func (info->stream, piece.style, "%s",
+                                   piece.text.c_str ());
+        break;
+      case stm8_insn_piece::ADDRESS:
+        info->print_address_func (piece.addr, info);
+        break;
+      }
+
+  return insn.length;
+}
+
+/* Implement the "print_insn" gdbarch method.  Share the symbol index of
+   the program space with the disassembler, so that only memory operands
+   that have a name are printed through print_address, which looks the
+   name up again with the user's print settings.
+   Instructions in read-only sections of objfiles are cached, so that
+   redisplaying code costs no target memory reads; the cache is flushed
+   when GDB writes to the memory.  Breakpoints need no flush, since
+   reads of target memory show the shadowed contents.  Only instructions
+   read from target memory are cached, not those decoded from a buffer
+   the caller supplies.  */
+
+static int
+stm8_gdb_print_insn (bfd_vma memaddr, disassemble_info *info)
+{
+  stm8_disassemble_set_symbol_index (
+      info, stm8_pspace_symbol_index (current_program_space));
+
+  stm8_insn_cache *cache = nullptr;
+  if (info->read_memory_func
+      == gdb_disassembler_memory_reader::dis_asm_read_memory)
+    cache = stm8_find_insn_cache (memaddr);
+  if (cache == nullptr)
+    return print_insn_stm8 (memaddr, info);
+
+  auto it = cache->insns.find (memaddr);
+  if (it != cache->insns.end ())
+    return stm8_replay_insn (it->second, info);
+
+  int length;
+  stm8_cached_insn insn;
+  {
+    stm8_insn_recorder rec (info);
+
+    length = print_insn_stm8 (memaddr, info);
+    insn = std::move (rec.insn);
+  }
+
+  if (length > 0)
+    {
+      if (cache->insns.size () >= STM8_INSN_CACHE_MAX)
+        cache->insns.clear ();
+      insn.length = length;
+      cache->insns.emplace (memaddr, std::move (insn));
+    }
+
+  return length;
+}
+
+/* Non-volatile memory regions of ld/scripttempl/stm8.sc.  Programs are
+   loaded into them through the flash path; everything else is RAM or
+   memory-mapped I/O.  This is the layout of the STM8S and STM8L parts the
+   default linker script is written for; other devices may differ, which
+   is why the built-in map is only used when asked for.  */
+
+struct stm8_nvm_region
+{
+  CORE_ADDR lo;
+  CORE_ADDR hi;
+  bool eeprom;
+};
+
+static const struct stm8_nvm_region stm8_nvm_regions[] = {
+  { 0x4000, 0x5000, true },             /* eeprom */
+  { 0x5000, 0x5100, true },             /* fuse */
+  { 0x5100, 0x5200, true },             /* lock */
+  { 0x8000, 0x8000 + 0x100000, false }, /* text */
+};
+
+/* The STM8 address space is 24 bits wide.  */
+#define STM8_ADDRESS_SPACE_END 0x1000000
+
+/* Whether to supply a memory map when the target does not, and the
+   program/erase block sizes used in it.  The map is off by default: it
+   makes plain writes to code fail, turns software breakpoints in it into
+   hardware ones, and needs a stub that supports the vFlash packets.  */
+static bool stm8_builtin_memory_map = false;
+static unsigned int stm8_flash_block_size = 128;
+static unsigned int stm8_eeprom_block_size = 128;
+
+/* Widen the flash extent in EXTENTS of the NVM region holding LO..HI, if
+   any, to cover that range in whole blocks.  */
+
+static void
+stm8_note_loaded_range (std::vector<std::pair<CORE_ADDR, CORE_ADDR>> &extents,
+                        CORE_ADDR lo, CORE_ADDR hi)
+{
+  for (size_t i = 0; i < ARRAY_SIZE (stm8_nvm_regions); i++)
+    {
+      const stm8_nvm_region &r = stm8_nvm_regions[i];
+      CORE_ADDR bs = (r.eeprom ? stm8_eeprom_block_size
+                               : stm8_flash_block_size);
+
+      if (lo < r.lo || lo >= r.hi)
+        continue;
+
+      lo = std::max (r.lo, lo / bs * bs);
+      hi = std::min (r.hi, (hi + bs - 1) / bs * bs);
+
+      if (extents[i].first == extents[i].second)
+        extents[i] = { lo, hi };
+      else
+        extents[i] = { std::min (extents[i].first, lo),
+                       std::max (extents[i].second, hi) };
+      return;
+    }
+}
+
+/* Implement the "memory_map" gdbarch method.  The flash regions are the
+   parts of the linker's NVM regions the executable loads anything into,
+   found from its program headers (or its sections if it has none), in
+   whole program blocks.  The rest of the address space stays plain RAM,
+   so I/O registers can still be written directly.  */
+
+static std::vector<mem_region>
+stm8_memory_map (struct gdbarch *gdbarch)
+{
+  std::vector<mem_region> map;
+  bfd *abfd = current_program_space->exec_bfd ();
+
+  if (!stm8_builtin_memory_map || abfd == nullptr)
+    return map;
+
+  std::vector<std::pair<CORE_ADDR, CORE_ADDR>> extents (
+      ARRAY_SIZE (stm8_nvm_regions));
+
+  if (bfd_get_flavour (abfd) == bfd_target_elf_flavour
+      && elf_tdata (abfd)->phdr != nullptr
+      && elf_elfheader (abfd)->e_phnum > 0)
+    {
+      Elf_Internal_Phdr *phdr = elf_tdata (abfd)->phdr;
+
+      for (unsigned int i = 0; i < elf_elfheader (abfd)->e_phnum; i++)
+        if (phdr[i].p_type == PT_LOAD && phdr[i].p_filesz > 0)
+          stm8_note_loaded_range (extents, phdr[i].p_paddr,
+                                  phdr[i].p_paddr + phdr[i].p_filesz);
+    }
+  else
+    {
+      for (asection *sec : gdb_bfd_sections (abfd))
+        if ((bfd_section_flags (sec) & SEC_LOAD) != 0
+            && bfd_section_size (sec) > 0)
+          stm8_note_loaded_range (extents, bfd_section_lma (sec),
+                                  bfd_section_lma (sec)
+                                      + bfd_section_size (sec));
+    }
+
+  /* Flash regions in address order, with RAM filling the gaps.  */
+  CORE_ADDR next = 0;
+
+  for (size_t i = 0; i < ARRAY_SIZE (stm8_nvm_regions); i++)
+    {
+      if (extents[i].first == extents[i].second)
+        continue;
+
+      if (next < extents[i].first)
+        map.emplace_back (next, extents[i].first, MEM_RW);
+
+      mem_attrib attrib;
+      attrib.mode = MEM_FLASH;
+      attrib.blocksize = (stm8_nvm_regions[i].eeprom ? stm8_eeprom_block_size
+                                                     : stm8_flash_block_size);
+      map.emplace_back (extents[i].first, extents[i].second, attrib);
+
+      next = extents[i].second;
+    }
+
+  if (map.empty ())
+    return map;
+
+  if (next < STM8_ADDRESS_SPACE_END)
+    map.emplace_back (next, STM8_ADDRESS_SPACE_END, MEM_RW);
+
+  stm8_debug_printf ("stm8_memory_map: %zu regions\n", map.size ());
+
+  return map;
+}
+
+/* Drop the cached memory map, so it is rebuilt for a new executable or
+   changed settings.  */
+
+static void
+stm8_memory_map_changed (program_space *pspace, bool reload)
+{
+  invalidate_target_mem_regions ();
+}
+
+static void
+set_stm8_memory_map_option (const char *args, int from_tty,
+                            struct cmd_list_element *c)
+{
+  if (stm8_flash_block_size == 0 || stm8_eeprom_block_size == 0)
+    {
+      if (stm8_flash_block_size == 0)
+        stm8_flash_block_size = 128;
+      if (stm8_eeprom_block_size == 0)
+        stm8_eeprom_block_size = 128;
+      error (_ ("Block size must be non-zero."));
+    }
+
+  invalidate_target_mem_regions ();
+}
+
 static const struct frame_unwind stm8_frame_unwind
     = { "stm8 prologue",
         NORMAL_FRAME,
@@ -895,15 +1582,15 @@ stm8_gdbarch_init (struct gdbarch_info info, struct gdbarch_list *arches)
         return NULL;
     }
 
-  /* If there is already a candidate, use it.  */
+  /* If there is already a candidate for the selected device, use it.  */
   for (gdbarch_list *best_arch = gdbarch_list_lookup_by_info (arches, &info);
        best_arch != nullptr;
        best_arch = gdbarch_list_lookup_by_info (best_arch->next, &info))
     {
       stm8_gdbarch_tdep *tdep
-          = gdbarch_tdep<stm8_gdbarch_tdep> (arches->gdbarch);
+          = gdbarch_tdep<stm8_gdbarch_tdep> (best_arch->gdbarch);
 
-      if (tdep)
+      if (tdep && tdep->device == stm8_current_device ())
         return best_arch->gdbarch;
     }
 
@@ -930,11 +1617,19 @@ stm8_gdbarch_init (struct gdbarch_info info, struct gdbarch_list *arches)
   set_tdesc_pseudo_register_name (gdbarch, stm8_register_name);
   set_tdesc_pseudo_register_type (gdbarch, stm8_register_type);
 
-  set_gdbarch_num_pseudo_regs (gdbarch, STM8_NUM_PSEUDOREGS);
+  tdep->device = stm8_current_device ();
+  if (tdep->device != nullptr)
+    stm8_init_periph_registers (gdbarch, tdep);
+
+  set_gdbarch_num_pseudo_regs (gdbarch,
+                               STM8_NUM_PSEUDOREGS
+                                   + tdep->periph_types.size ());
   set_gdbarch_pseudo_register_read (gdbarch, stm8_pseudo_register_read);
   set_gdbarch_deprecated_pseudo_register_write (gdbarch,
                                                 stm8_pseudo_register_write);
 
+  set_gdbarch_register_reggroup_p (gdbarch, stm8_register_reggroup_p);
+
   set_gdbarch_convert_register_p (gdbarch, stm8_convert_register_p);
   set_gdbarch_register_to_value (gdbarch, stm8_register_to_value);
 
@@ -963,7 +1658,9 @@ stm8_gdbarch_init (struct gdbarch_info info, struct gdbarch_list *arches)
 
   set_gdbarch_breakpoint_from_pc (gdbarch, stm8_breakpoint_from_pc);
 
-  set_gdbarch_print_insn (gdbarch, print_insn_stm8);
+  set_gdbarch_print_insn (gdbarch, stm8_gdb_print_insn);
+
+  set_gdbarch_memory_map (gdbarch, stm8_memory_map);
 
   set_gdbarch_write_pc (gdbarch, stm8_write_pc);
 
@@ -980,6 +1677,49 @@ stm8_gdbarch_init (struct gdbarch_info info, struct gdbarch_list *arches)
   return gdbarch;
 }
 
+/* Name of the device file given with "set stm8 device-file".  */
+static std::string stm8_device_file;
+
+static void
+set_stm8_device_file (const char *args, int from_tty,
+                      struct cmd_list_element *c)
+{
+  stm8_device *previous = stm8_current_device ();
+
+  try
+    {
+      stm8_select_device_file (stm8_device_file.c_str ());
+    }
+  catch (const gdb_exception_error &)
+    {
+      stm8_device_file = previous != nullptr ? previous->filename : "";
+      throw;
+    }
+
+  /* Switch to an architecture that has the new device's registers.  */
+  if (gdbarch_bfd_arch_info (current_inferior ()->arch ())->arch
+      == bfd_arch_stm8)
+    {
+      gdbarch_info info;
+
+      if (!gdbarch_update_p (info))
+        internal_error (_ ("could not update architecture"));
+
+      registers_changed ();
+      reinit_frame_cache ();
+    }
+}
+
+static void
+show_stm8_device_file (struct ui_file *file, int from_tty,
+                       struct cmd_list_element *c, const char *value)
+{
+  if (*value == '\0')
+    gdb_printf (file, _ ("No STM8 device file is loaded.\n"));
+  else
+    gdb_printf (file, _ ("The STM8 device file is \"%s\".\n"), value);
+}
+
 static void
 show_stm8_debug (struct ui_file *file, int from_tty,
                  struct cmd_list_element *c, const char *value)
@@ -987,6 +1727,9 @@ show_stm8_debug (struct ui_file *file, int from_tty,
   gdb_printf (file, _ ("stm8 debugging is %s.\n"), value);
 }
 
+static struct cmd_list_element *set_stm8_list;
+static struct cmd_list_element *show_stm8_list;
+
 void _initialize_stm8_tdep ();
 void
 _initialize_stm8_tdep ()
@@ -1002,4 +1745,88 @@ Show stm8 debugging."),
 When non-zero, stm8 debugging is enabled."),
                              NULL, show_stm8_debug, &setdebuglist,
                              &showdebuglist);
+
+  add_setshow_prefix_cmd ("stm8", class_support,
+                          _ ("Set STM8 specific variables."),
+                          _ ("Show STM8 specific variables."), &set_stm8_list,
+                          &show_stm8_list, &setlist, &showlist);
+
+  add_setshow_optional_filename_cmd ("device-file", class_support,
+                                     &stm8_device_file, _ ("\
+Set the file describing the peripheral registers of the STM8 device."),
+                                     _ ("\
+Show the file describing the peripheral registers of the STM8 device."),
+                                     _ ("\
+The file names the memory-mapped registers of each peripheral and their\n\
+bitfields.  They are shown by \"info registers peripheral\", or per\n\
+peripheral by \"info registers NAME\".  An empty name drops the device."),
+                                     set_stm8_device_file,
+                                     show_stm8_device_file, &set_stm8_list,
+                                     &show_stm8_list);
+
+  add_setshow_boolean_cmd ("builtin-memory-map", class_support,
+                           &stm8_builtin_memory_map, _ ("\
+Set whether to use the built-in STM8 memory map."),
+                           _ ("\
+Show whether to use the built-in STM8 memory map."),
+                           _ ("\
+When on, and the target does not supply a memory map, the flash, EEPROM\n\
+and option byte areas the executable loads into are treated as flash,\n\
+so \"load\" programs them block-wise through the target's flash\n\
+commands.  The areas are those of the default STM8 linker script: EEPROM\n\
+at 0x4000, option bytes at 0x5000 and program memory from 0x8000.\n\
+Flash can then not be written as plain memory, and breakpoints in it are\n\
+hardware breakpoints.  Only turn this on for stubs that support flash\n\
+programming.  The default is off."),
+                           set_stm8_memory_map_option, NULL, &set_stm8_list,
+                           &show_stm8_list);
+
+  add_setshow_zuinteger_cmd ("flash-block-size", class_support,
+                             &stm8_flash_block_size, _ ("\
+Set the STM8 program memory block size."),
+                             _ ("\
+Show the STM8 program memory block size."),
+                             _ ("\
+Flash is erased and written in blocks of this many bytes."),
+                             set_stm8_memory_map_option, NULL, &set_stm8_list,
+                             &show_stm8_list);
+
+  add_setshow_zuinteger_cmd ("eeprom-block-size", class_support,
+                             &stm8_eeprom_block_size, _ ("\
+Set the STM8 data EEPROM block size."),
+                             _ ("\
+Show the STM8 data EEPROM block size."),
+                             _ ("\
+EEPROM and option bytes are erased and written in blocks of this many\n\
+bytes."),
+                             set_stm8_memory_map_option, NULL, &set_stm8_list,
+                             &show_stm8_list);
+
+  add_setshow_boolean_cmd ("disassembly-cache", class_support,
+                           &stm8_disassembly_cache, _ ("\
+Set whether to cache the disassembly of read-only code."),
+                           _ ("\
+Show whether to cache the disassembly of read-only code."),
+                           _ ("\
+When on, instructions in read-only sections of the executable and shared\n\
+objects are decoded once and printed from a cache afterwards, without\n\
+reading target memory.  Writes to the memory flush the affected\n\
+instructions; \"load\", reading new symbols or starting a program flushes\n\
+them all."),
+                           NULL, NULL, &set_stm8_list, &show_stm8_list);
+
+  gdb::observers::executable_changed.attach (stm8_memory_map_changed,
+                                             "stm8-tdep");
+  gdb::observers::new_objfile.attach (stm8_symbol_index_objfiles_changed,
+                                      "stm8-tdep");
+  gdb::observers::free_objfile.attach (stm8_symbol_index_objfiles_changed,
+                                       "stm8-tdep");
+  gdb::observers::memory_changed.attach (stm8_insn_cache_memory_changed,
+                                         "stm8-tdep");
+  gdb::observers::new_objfile.attach (stm8_insn_cache_new_objfile,
+                                      "stm8-tdep");
+  gdb::observers::target_changed.attach (stm8_insn_cache_target_changed,
+                                         "stm8-tdep");
+  gdb::observers::inferior_created.attach (stm8_insn_cache_inferior_created,
+                                           "stm8-tdep");
 }
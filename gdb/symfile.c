@@ -1877,6 +1877,11 @@ load_command (const char *arg, int from_tty)
 
   target_load (arg, from_tty);
 
+  /* Loading rewrote the target's memory without going through
+     write_memory_with_notification, so tell everyone who caches
+     target state.  */
+  gdb::observers::target_changed.notify (current_inferior ()->top_target ());
+
   /* After re-loading the executable, we don't really know which
      overlays are mapped any more.  */
   overlay_cache_invalid = 1;
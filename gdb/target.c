@@ -1854,13 +1854,21 @@ target_write_raw_memory (CORE_ADDR memaddr, const gdb_byte *myaddr, ssize_t len)
     return -1;
 }
 
-/* Fetch the target's memory map.  */
+/* Fetch the target's memory map, falling back to the architecture's
+   built-in map if the target does not supply one.  */
 
 std::vector<mem_region>
 target_memory_map (void)
 {
   target_ops *target = current_inferior ()->top_target ();
   std::vector<mem_region> result = target->memory_map ();
+  if (result.empty ())
+    {
+      gdbarch *arch = current_inferior ()->arch ();
+
+      if (gdbarch_memory_map_p (arch))
+	result = gdbarch_memory_map (arch);
+    }
   if (result.empty ())
     return result;
 
@@ -0,0 +1,99 @@
+#!/bin/sh
+
+# workqueue_bench.sh -- time a link of many objects with different
+# thread counts, to measure the scaling of the gold workqueue.
+
+# Copyright (C) 2024 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This is not run by "make check".  Run it by hand from the gold build
+# directory, for example:
+#   sh ../../gold/testsuite/workqueue_bench.sh ./ld-new
+# The environment variables OBJECTS (default 10000), THREADS (default
+# "1 2 4 8 16 32 64"), RUNS (default 3) and CC (default cc) may be set
+# to change what is measured.  The objects are generated in a scratch
+# directory, which is removed afterwards.
+
+set -e
+
+LD=${1:-./ld-new}
+case $LD in
+  /*) ;;
+  *) LD=`pwd`/$LD ;;
+esac
+OBJECTS=${OBJECTS:-10000}
+THREADS=${THREADS:-"1 2 4 8 16 32 64"}
+RUNS=${RUNS:-3}
+CC=${CC:-cc}
+
+dir=`pwd`/`mktemp -d workqueue_bench.XXXXXX`
+trap 'rm -rf "$dir"' 0
+cd "$dir"
+
+# Each object has some code, data and relocations against symbols in
+# its neighbours, so that every phase of the link has work to do.
+i=0
+while test $i -lt $OBJECTS; do
+  next=$(( ($i + 1) % $OBJECTS ))
+  cat > f$i.c <<EOF
+extern int v$next;
+extern int f$next (int);
+int v$i = $i;
+static const char s$i[] = "object $i";
+int f$i (int x)
+{
+  if (x <= 0)
+    return v$next + s$i[0];
+  return f$next (x - 1) + v$i;
+}
+EOF
+  echo f$i.o >> objects
+  i=$(($i + 1))
+done
+
+cat > main.c <<EOF
+extern int f0 (int);
+int main (void) { return f0 (3) == 0; }
+EOF
+echo main.o >> objects
+
+for f in *.c; do
+  echo $f
+done | xargs -n 64 $CC -c -O1 -ffunction-sections -fdata-sections
+rm -f *.c
+
+echo "$OBJECTS objects"
+for t in $THREADS; do
+  if test $t -eq 1; then
+    opts=--no-threads
+  else
+    opts="--threads --thread-count=$t"
+  fi
+  best=
+  r=0
+  while test $r -lt $RUNS; do
+    start=`date +%s.%N`
+    $LD -o bench.out -e main $opts @objects
+    end=`date +%s.%N`
+    best=`echo "$start $end $best" \
+      | awk '{ t = $2 - $1; if (NF == 2 || t < $3) print t; else print $3 }'`
+    r=$(($r + 1))
+  done
+  echo "threads $t: $best s"
+done
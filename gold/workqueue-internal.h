@@ -37,6 +37,67 @@ namespace gold
 
 class Workqueue_thread;
 
+// A run queue for the Tasks queued by the Tasks running on one
+// thread.  The owning thread adds Tasks to it while holding only the
+// lock of the run queue, not the master Workqueue lock.  Tasks are
+// removed by the owning thread and stolen by idle threads, in both
+// cases with the master Workqueue lock held as well, since checking
+// whether a Task is runnable requires it.
+
+class Workqueue_runqueue
+{
+ public:
+  Workqueue_runqueue()
+    : lock_(), first_tasks_(), tasks_()
+  { }
+
+  // Add T to the run queue.  If FRONT is true, put it at the front.
+  void
+  push(Task* t, bool front)
+  {
+    Hold_lock hl(this->lock_);
+    Task_list* queue = (t->should_run_soon()
+			? &this->first_tasks_
+			: &this->tasks_);
+    if (front)
+      queue->push_front(t);
+    else
+      queue->push_back(t);
+  }
+
+  // Remove the first Task which should run soon, or the first Task
+  // if SOON_ONLY is false.  Return NULL if there is none.
+  Task*
+  pop(bool soon_only)
+  {
+    Hold_lock hl(this->lock_);
+    Task* t = this->first_tasks_.pop_front();
+    if (t == NULL && !soon_only)
+      t = this->tasks_.pop_front();
+    return t;
+  }
+
+  // Return whether the run queue is empty.
+  bool
+  empty()
+  {
+    Hold_lock hl(this->lock_);
+    return this->first_tasks_.empty() && this->tasks_.empty();
+  }
+
+ private:
+  // This class can not be copied.
+  Workqueue_runqueue(const Workqueue_runqueue&);
+  Workqueue_runqueue& operator=(const Workqueue_runqueue&);
+
+  // Lock for the lists.
+  Lock lock_;
+  // List of tasks to execute soon.
+  Task_list first_tasks_;
+  // List of tasks to execute after the ones in first_tasks_.
+  Task_list tasks_;
+};
+
 // The Workqueue_threader abstract class.  This is the interface used
 // by the general workqueue code to manage threads.
 
@@ -58,6 +119,22 @@ class Workqueue_threader
   virtual bool
   should_cancel_thread(int thread_number) = 0;
 
+  // Return whether each thread should have its own run queue.
+  virtual bool
+  uses_runqueues() const
+  { return false; }
+
+  // Set the run queue of the calling thread.
+  virtual void
+  set_current_runqueue(Workqueue_runqueue*)
+  { }
+
+  // Return the run queue of the calling thread, or NULL if it does
+  // not have one.
+  virtual Workqueue_runqueue*
+  current_runqueue()
+  { return NULL; }
+
  protected:
   // Get the Workqueue.
   Workqueue*
@@ -86,6 +163,19 @@ class Workqueue_threader_threadpool : public Workqueue_threader
   bool
   should_cancel_thread(int thread_number);
 
+  // Every thread gets its own run queue.
+  bool
+  uses_runqueues() const
+  { return true; }
+
+  // Set the run queue of the calling thread.
+  void
+  set_current_runqueue(Workqueue_runqueue*);
+
+  // Return the run queue of the calling thread.
+  Workqueue_runqueue*
+  current_runqueue();
+
   // Process all tasks.  This keeps running until told to cancel.
   void
   process(int thread_number)
@@ -124,6 +124,24 @@ Workqueue_thread::thread_body(void* arg)
 
 // Class Workqueue_threader_threadpool.
 
+// The thread specific key which holds the run queue of each thread.
+
+static pthread_key_t runqueue_key;
+static pthread_once_t runqueue_key_once = PTHREAD_ONCE_INIT;
+
+extern "C"
+{
+
+static void
+create_runqueue_key()
+{
+  int err = pthread_key_create(&runqueue_key, NULL);
+  if (err != 0)
+    gold_fatal(_("pthread_key_create failed: %s"), strerror(err));
+}
+
+}
+
 // Constructor.
 
 Workqueue_threader_threadpool::Workqueue_threader_threadpool(
@@ -134,6 +152,9 @@ Workqueue_threader_threadpool::Workqueue_threader_threadpool(
     desired_thread_count_(1),
     threads_(1)
 {
+  int err = pthread_once(&runqueue_key_once, create_runqueue_key);
+  if (err != 0)
+    gold_fatal(_("pthread_once failed: %s"), strerror(err));
 }
 
 // Destructor.
@@ -194,6 +215,25 @@ Workqueue_threader_threadpool::should_cancel_thread(int thread_number)
   return false;
 }
 
+// Set the run queue of the calling thread.
+
+void
+Workqueue_threader_threadpool::set_current_runqueue(Workqueue_runqueue* rq)
+{
+  int err = pthread_setspecific(runqueue_key, rq);
+  if (err != 0)
+    gold_fatal(_("pthread_setspecific failed: %s"), strerror(err));
+}
+
+// Return the run queue of the calling thread.  This is NULL for a
+// thread which is not processing the Workqueue.
+
+Workqueue_runqueue*
+Workqueue_threader_threadpool::current_runqueue()
+{
+  return static_cast<Workqueue_runqueue*>(pthread_getspecific(runqueue_key));
+}
+
 } // End namespace gold.
 
 #endif // defined(ENABLE_THREADS)
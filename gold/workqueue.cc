@@ -123,6 +123,8 @@ Workqueue::Workqueue(const General_options& options)
     running_(0),
     waiting_(0),
     condvar_(this->lock_),
+    runqueues_(),
+    sleeping_(0),
     threader_(NULL)
 {
   bool threads = options.threads();
@@ -143,6 +145,10 @@ Workqueue::Workqueue(const General_options& options)
 
 Workqueue::~Workqueue()
 {
+  for (std::vector<Workqueue_runqueue*>::iterator p = this->runqueues_.begin();
+       p != this->runqueues_.end();
+       ++p)
+    delete *p;
 }
 
 // Add a task to the end of a specific queue, or put it on the list
@@ -151,6 +157,26 @@ Workqueue::~Workqueue()
 void
 Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
 {
+  // A Task queued by a running Task goes on the run queue of the
+  // current thread.  Whether it is runnable is checked when it is
+  // taken off again.  We only need lock_ to wake up a sleeping
+  // thread, which can then steal the Task.
+  Workqueue_runqueue* rq = this->threader_->current_runqueue();
+  if (rq != NULL)
+    {
+      rq->push(t, front);
+      // This pairs with the increment of sleeping_ in
+      // find_runnable_or_wait: either we see the sleeping thread, or
+      // it sees the Task on our run queue.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (this->sleeping_.load() > 0)
+	{
+	  Hold_lock hl(this->lock_);
+	  this->condvar_.signal();
+	}
+      return;
+    }
+
   Hold_lock hl(this->lock_);
 
   Task_token* token = t->is_runnable();
@@ -207,6 +233,23 @@ Workqueue::should_cancel_thread(int thread_number)
   return this->threader_->should_cancel_thread(thread_number);
 }
 
+// Return whether T is runnable.  If it is waiting for a Token, add it
+// to the list for that Token.  The workqueue lock must be held when
+// this is called.
+
+bool
+Workqueue::runnable_or_add_waiting(Task* t)
+{
+  Task_token* token = t->is_runnable();
+
+  if (token == NULL)
+    return true;
+
+  token->add_waiting(t);
+  ++this->waiting_;
+  return false;
+}
+
 // Find a runnable task in TASKS.  Return NULL if none could be found.
 // If we find a Task waiting for a Token, add it to the list for that
 // Token.  The workqueue lock must be held when this is called.
@@ -217,28 +260,57 @@ Workqueue::find_runnable_in_list(Task_list* tasks)
   Task* t;
   while ((t = tasks->pop_front()) != NULL)
     {
-      Task_token* token = t->is_runnable();
-
-      if (token == NULL)
+      if (this->runnable_or_add_waiting(t))
 	return t;
-
-      token->add_waiting(t);
-      ++this->waiting_;
     }
 
   // We couldn't find any runnable task.
   return NULL;
 }
 
+// Likewise for the run queue RQ.  If SOON_ONLY is true, only look at
+// Tasks which should run soon.
+
+Task*
+Workqueue::find_runnable_in_runqueue(Workqueue_runqueue* rq, bool soon_only)
+{
+  Task* t;
+  while ((t = rq->pop(soon_only)) != NULL)
+    {
+      if (this->runnable_or_add_waiting(t))
+	return t;
+    }
+  return NULL;
+}
+
 // Find a runnable task.  Return NULL if none could be found.  The
 // workqueue lock must be held when this is called.
 
 Task*
 Workqueue::find_runnable()
 {
-  Task* t = this->find_runnable_in_list(&this->first_tasks_);
+  // Prefer the Tasks queued on this thread, then the shared lists.
+  Workqueue_runqueue* own = this->threader_->current_runqueue();
+  Task* t = NULL;
+  if (own != NULL)
+    t = this->find_runnable_in_runqueue(own, true);
+  if (t == NULL)
+    t = this->find_runnable_in_list(&this->first_tasks_);
+  if (t == NULL && own != NULL)
+    t = this->find_runnable_in_runqueue(own, false);
   if (t == NULL)
     t = this->find_runnable_in_list(&this->tasks_);
+
+  // Otherwise steal a Task queued on another thread.
+  for (std::vector<Workqueue_runqueue*>::const_iterator p =
+	 this->runqueues_.begin();
+       t == NULL && p != this->runqueues_.end();
+       ++p)
+    {
+      if (*p != NULL && *p != own)
+	t = this->find_runnable_in_runqueue(*p, false);
+    }
+
   return t;
 }
 
@@ -267,13 +339,24 @@ Workqueue::find_runnable_or_wait(int thread_number)
       if (this->should_cancel_thread(thread_number))
 	return NULL;
 
-      gold_debug(DEBUG_TASK, "%3d sleeping", thread_number);
+      // A thread queueing a Task on its run queue only wakes us up if
+      // it sees that we are sleeping, so look once more after saying
+      // so.
+      ++this->sleeping_;
+      if (!this->runqueues_.empty())
+	t = this->find_runnable();
+
+      if (t == NULL)
+	{
+	  gold_debug(DEBUG_TASK, "%3d sleeping", thread_number);
 
-      this->condvar_.wait();
+	  this->condvar_.wait();
 
-      gold_debug(DEBUG_TASK, "%3d awake", thread_number);
+	  gold_debug(DEBUG_TASK, "%3d awake", thread_number);
 
-      t = this->find_runnable();
+	  t = this->find_runnable();
+	}
+      --this->sleeping_;
     }
 
   return t;
@@ -416,6 +499,9 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
     should_return = true;
   else if (!this->first_tasks_.empty() || !this->tasks_.empty())
     should_queue = true;
+  else if (this->threader_->current_runqueue() != NULL
+	   && !this->threader_->current_runqueue()->empty())
+    should_queue = true;
   else
     should_return = true;
 
@@ -492,8 +578,27 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
 void
 Workqueue::process(int thread_number)
 {
+  if (this->threader_->uses_runqueues())
+    {
+      Workqueue_runqueue* rq;
+      {
+	Hold_lock hl(this->lock_);
+	if (this->runqueues_.size() <= static_cast<size_t>(thread_number))
+	  this->runqueues_.resize(thread_number + 1, NULL);
+	rq = this->runqueues_[thread_number];
+	if (rq == NULL)
+	  {
+	    rq = new Workqueue_runqueue();
+	    this->runqueues_[thread_number] = rq;
+	  }
+      }
+      this->threader_->set_current_runqueue(rq);
+    }
+
   while (this->find_and_run_task(thread_number))
     ;
+
+  this->threader_->set_current_runqueue(NULL);
 }
 
 // Set the number of threads to use for the workqueue, if we are using
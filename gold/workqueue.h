@@ -27,7 +27,9 @@
 #ifndef GOLD_WORKQUEUE_H
 #define GOLD_WORKQUEUE_H
 
+#include <atomic>
 #include <string>
+#include <vector>
 
 #include "gold-threads.h"
 #include "token.h"
@@ -194,6 +196,7 @@ class Task_function : public Task
 // The workqueue itself.
 
 class Workqueue_threader;
+class Workqueue_runqueue;
 
 class Workqueue
 {
@@ -254,6 +257,15 @@ class Workqueue
   Task*
   find_runnable_in_list(Task_list*);
 
+  // Find a runnable task in a per-thread run queue.
+  Task*
+  find_runnable_in_runqueue(Workqueue_runqueue*, bool soon_only);
+
+  // Return whether T is runnable.  If not, add it to the list of
+  // Tasks waiting for the Token.
+  bool
+  runnable_or_add_waiting(Task* t);
+
   // Find an run a task.
   bool
   find_and_run_task(int);
@@ -284,6 +296,15 @@ class Workqueue
   // Condition variable associated with lock_.  This is signalled when
   // there may be a new Task to execute.
   Condvar condvar_;
+  // Per-thread run queues, indexed by thread number.  When using
+  // threads, a Task queued by a running Task goes on the run queue of
+  // the thread running it, which does not require lock_.  Idle
+  // threads steal Tasks from the other run queues.
+  std::vector<Workqueue_runqueue*> runqueues_;
+  // Number of threads waiting on condvar_.  This is changed with
+  // lock_ held, but it is read without it when queueing a Task on a
+  // run queue, to decide whether to wake up another thread.
+  std::atomic<int> sleeping_;
 
   // The threading implementation.  This is set at construction time
   // and not changed thereafter.
@@ -54,6 +54,7 @@ extern void vax_find_call   (Sym *, bfd_vma, bfd_vma);
 extern void sparc_find_call (Sym *, bfd_vma, bfd_vma);
 extern void mips_find_call  (Sym *, bfd_vma, bfd_vma);
 extern void aarch64_find_call (Sym *, bfd_vma, bfd_vma);
+extern void stm8_find_call (Sym *, bfd_vma, bfd_vma);
 
 static void
 parse_error (const char *filename)
@@ -327,6 +328,10 @@ find_call (Sym *parent, bfd_vma p_lowpc, bfd_vma p_highpc)
       aarch64_find_call (parent, p_lowpc, p_highpc);
       break;
 
+    case bfd_arch_stm8:
+      stm8_find_call (parent, p_lowpc, p_highpc);
+      break;
+
     default:
       fprintf (stderr, _("%s: -c not supported on architecture %s\n"),
 	       whoami, bfd_printable_name(core_bfd));
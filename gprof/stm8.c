@@ -0,0 +1,173 @@
+/* Gprof -c option support for STM8.
+
+   Copyright (C) 2024 Free Software Foundation, Inc.
+
+   This file is part of GNU Binutils.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston, MA
+   02110-1301, USA.  */
+
+#include "gprof.h"
+#include "search_list.h"
+#include "source.h"
+#include "symtab.h"
+#include "cg_arcs.h"
+#include "corefile.h"
+#include "hist.h"
+#include "dis-asm.h"
+
+/* STM8 instructions have a variable length, so the function body is
+   walked with the opcodes disassembler, which decodes lengths and
+   operands from the opcode table in opcodes/stm8-opc.c.  The text it
+   prints is discarded except for the mnemonic; direct branch targets are
+   reported through print_address_func.  */
+
+struct stm8_insn
+{
+  char mnemonic[8];
+  bool has_target;
+  bfd_vma target;
+};
+
+static int ATTRIBUTE_PRINTF (2, 3)
+stm8_ignore_text (void *stream ATTRIBUTE_UNUSED,
+		  const char *fmt ATTRIBUTE_UNUSED, ...)
+{
+  return 0;
+}
+
+static int ATTRIBUTE_PRINTF (3, 4)
+stm8_record_mnemonic (void *stream, enum disassembler_style style,
+		      const char *fmt, ...)
+{
+  struct stm8_insn *insn = stream;
+  va_list ap;
+
+  if (style != dis_style_mnemonic || insn->mnemonic[0] != '\0')
+    return 0;
+
+  va_start (ap, fmt);
+  vsnprintf (insn->mnemonic, sizeof (insn->mnemonic), fmt, ap);
+  va_end (ap);
+  insn->mnemonic[strcspn (insn->mnemonic, " \t")] = '\0';
+  return 0;
+}
+
+static void
+stm8_record_target (bfd_vma addr, struct disassemble_info *info)
+{
+  struct stm8_insn *insn = info->stream;
+
+  insn->has_target = true;
+  insn->target = addr;
+}
+
+void stm8_find_call (Sym *, bfd_vma, bfd_vma);
+
+void
+stm8_find_call (Sym *parent, bfd_vma p_lowpc, bfd_vma p_highpc)
+{
+  static disassembler_ftype print_insn;
+  static bool initialized;
+  struct disassemble_info info;
+  struct stm8_insn insn;
+  bfd_vma pc, dest_pc;
+  Sym *child;
+  int len;
+
+  if (!initialized)
+    {
+      print_insn = disassembler (bfd_arch_stm8, false, 0, core_bfd);
+      initialized = true;
+    }
+  if (print_insn == NULL)
+    {
+      fprintf (stderr, _("%s: -c not supported on architecture %s\n"),
+	       whoami, bfd_printable_name (core_bfd));
+      ignore_direct_calls = false;
+      return;
+    }
+
+  init_disassemble_info (&info, &insn, stm8_ignore_text,
+			 stm8_record_mnemonic);
+  info.arch = bfd_arch_stm8;
+  info.print_address_func = stm8_record_target;
+  info.buffer = (bfd_byte *) core_text_space;
+  info.buffer_vma = core_text_sect->vma;
+  info.buffer_length = bfd_section_size (core_text_sect);
+  disassemble_init_for_target (&info);
+
+  DBG (CALLDEBUG, printf ("[find_call] %s: 0x%lx to 0x%lx\n",
+			  parent->name, (unsigned long) p_lowpc,
+			  (unsigned long) p_highpc));
+
+  for (pc = p_lowpc; pc < p_highpc; pc += len)
+    {
+      insn.mnemonic[0] = '\0';
+      insn.has_target = false;
+
+      len = print_insn (pc, &info);
+      if (len <= 0)
+	break;
+
+      /* CALL/CALLR and the tail call forms JP/JPF.  Indirect forms
+	 have no target and are skipped.  */
+      if (!insn.has_target
+	  || (strcmp (insn.mnemonic, "call") != 0
+	      && strcmp (insn.mnemonic, "callr") != 0
+	      && strcmp (insn.mnemonic, "callf") != 0
+	      && strcmp (insn.mnemonic, "jp") != 0
+	      && strcmp (insn.mnemonic, "jpf") != 0))
+	continue;
+
+      DBG (CALLDEBUG,
+	   printf ("[find_call] 0x%lx: %s", (unsigned long) pc,
+		   insn.mnemonic));
+
+      /* CALL and JP take a 16-bit address within the current 64K
+	 section of program memory.  */
+      dest_pc = insn.target;
+      if (strcmp (insn.mnemonic, "call") == 0
+	  || strcmp (insn.mnemonic, "jp") == 0)
+	dest_pc = (pc & ~(bfd_vma) 0xffff) | (dest_pc & 0xffff);
+
+      if (hist_check_address (dest_pc))
+	{
+	  child = sym_lookup (&symtab, dest_pc);
+
+	  if (child)
+	    {
+	      DBG (CALLDEBUG,
+		   printf ("\tdest_pc=0x%lx, (name=%s, addr=0x%lx)\n",
+			   (unsigned long) dest_pc, child->name,
+			   (unsigned long) child->addr));
+
+	      /* Jumps within the function are not calls.  */
+	      if (child->addr == dest_pc
+		  && (child != parent || insn.mnemonic[0] == 'c'))
+		{
+		  /* a hit.  */
+		  arc_add (parent, child, (unsigned long) 0);
+		  continue;
+		}
+	    }
+	}
+
+      /* Something funny going on.  */
+      DBG (CALLDEBUG, printf ("\tbut it's a botch\n"));
+    }
+
+  disassemble_free_target (&info);
+}
@@ -756,6 +756,11 @@ struct bfd_link_info
   /* The maximum cache size.  Backend can use cache_size and and
      max_cache_size to decide if keep_memory should be honored.  */
   bfd_size_type max_cache_size;
+
+  /* The maximum number of threads to use for the parts of the link
+     that can be done in parallel.  Zero or one means no threads.  No
+     more threads are started than there are processors.  */
+  unsigned int threads;
 };
 
 /* Some forward-definitions used by some callbacks.  */
@@ -375,6 +375,15 @@ extern int print_insn_rl78_g13		(bfd_vma, disassemble_info *);
 extern int print_insn_rl78_g14		(bfd_vma, disassemble_info *);
 extern int print_insn_stm8		(bfd_vma, disassemble_info *);
 
+/* Address-sorted, per-section symbol index the STM8 disassembler uses to
+   name memory operands.  Built once per symbol table and either owned by
+   the disassembler (objdump) or shared with it by the caller (gdb).  */
+struct stm8_symbol_index;
+extern struct stm8_symbol_index *stm8_symbol_index_create (asymbol **, long);
+extern void stm8_symbol_index_free (struct stm8_symbol_index *);
+extern void stm8_disassemble_set_symbol_index
+  (struct disassemble_info *, const struct stm8_symbol_index *);
+
 extern disassembler_ftype arc_get_disassembler (bfd *);
 extern disassembler_ftype cris_get_disassembler (bfd *);
 
@@ -268,6 +268,12 @@ typedef struct
 
   bool stats;
 
+  /* If TRUE, have the bfd file cache map input files into memory.  */
+  bool mmap_inputs;
+
+  /* If TRUE, --stats output is a JSON object.  */
+  bool stats_json;
+
   /* If set, orphan input sections will be mapped to separate output
      sections.  */
   bool unique_orphan_sections;
@@ -294,6 +300,9 @@ typedef struct
 
   char *dependency_file;
 
+  /* If set, write a JSON report of memory region usage to this file.  */
+  char *size_report_file;
+
   unsigned int split_by_reloc;
   bfd_size_type split_by_file;
 
@@ -2869,6 +2869,8 @@ static lang_input_statement_type *
 lookup_name (const char *name)
 {
   lang_input_statement_type *search;
+  enum ld_phase phase;
+  bool loaded;
 
   for (search = (void *) input_file_chain.head;
        search != NULL;
@@ -2910,7 +2912,10 @@ lookup_name (const char *name)
   if (search->flags.loaded || !search->flags.real)
     return search;
 
-  if (!load_symbols (search, NULL))
+  phase = ld_set_phase (ld_phase_open);
+  loaded = load_symbols (search, NULL);
+  ld_set_phase (phase);
+  if (!loaded)
     return NULL;
 
   return search;
@@ -2984,6 +2989,7 @@ load_symbols (lang_input_statement_type *entry,
 	      lang_statement_list_type *place)
 {
   char **matching;
+  enum ld_phase phase;
 
   if (entry->flags.loaded)
     return true;
@@ -3126,10 +3132,14 @@ load_symbols (lang_input_statement_type *entry,
       break;
     }
 
+  /* Searching an archive is timed separately from loading objects.  */
+  phase = ld_set_phase (bfd_get_format (entry->the_bfd) == bfd_archive
+			? ld_phase_archive : ld_phase_open);
   if (bfd_link_add_symbols (entry->the_bfd, &link_info))
     entry->flags.loaded = true;
   else
     einfo (_("%F%P: %pB: error adding symbols: %E\n"), entry->the_bfd);
+  ld_set_phase (phase);
 
   return entry->flags.loaded;
 }
@@ -3529,6 +3539,8 @@ open_input_bfds (lang_statement_union_type *s,
 		 lang_output_section_statement_type *os,
 		 enum open_bfd_mode mode)
 {
+  enum ld_phase phase;
+
   for (; s != NULL; s = s->header.next)
     {
       switch (s->header.type)
@@ -3618,8 +3630,10 @@ open_input_bfds (lang_statement_union_type *s,
 	      os_tail = lang_os_list.tail;
 	      lang_list_init (&add);
 
+	      phase = ld_set_phase (ld_phase_open);
 	      if (!load_symbols (&s->input_statement, &add))
 		config.make_executable = false;
+	      ld_set_phase (phase);
 
 	      if (add.head != NULL)
 		{
@@ -8127,6 +8141,8 @@ reset_resolved_wilds (void)
 void
 lang_process (void)
 {
+  enum ld_phase phase;
+
   /* Finalize dynamic list.  */
   if (link_info.dynamic_list)
     lang_finalize_version_expr_head (&link_info.dynamic_list->head);
@@ -8337,10 +8353,13 @@ lang_process (void)
   if (0)
     debug_prefix_tree ();
 
+  phase = ld_set_phase (ld_phase_wild);
   resolve_wilds ();
 
   /* Remove unreferenced sections if asked to.  */
+  ld_set_phase (ld_phase_gc);
   lang_gc_sections ();
+  ld_set_phase (phase);
 
   lang_mark_undefineds ();
 
@@ -8352,6 +8371,7 @@ lang_process (void)
   /* There might have been new sections created (e.g. as result of
      checking relocs to need a .got, or suchlike), so to properly order
      them into our lists of matching sections reset them here.  */
+  phase = ld_set_phase (ld_phase_wild);
   reset_resolved_wilds ();
   resolve_wilds ();
 
@@ -8373,6 +8393,7 @@ lang_process (void)
 
   /* Find any sections not attached explicitly and handle them.  */
   lang_place_orphans ();
+  ld_set_phase (phase);
 
   if (!bfd_link_relocatable (&link_info))
     {
@@ -8382,7 +8403,9 @@ lang_process (void)
 	 sections, so that GCed sections are not merged, but before
 	 assigning dynamic symbols, since removing whole input sections
 	 is hard then.  */
+      phase = ld_set_phase (ld_phase_merge);
       bfd_merge_sections (link_info.output_bfd, &link_info);
+      ld_set_phase (phase);
 
       /* Look for a text section and set the readonly attribute in it.  */
       found = bfd_get_section_by_name (link_info.output_bfd, ".text");
@@ -8420,6 +8443,7 @@ lang_process (void)
 
   /* Do anything special before sizing sections.  This is where ELF
      and other back-ends size dynamic sections.  */
+  phase = ld_set_phase (ld_phase_size);
   ldemul_before_allocation ();
 
   /* We must record the program headers before we try to fix the
@@ -8436,6 +8460,7 @@ lang_process (void)
   /* See if anything special should be done now we know how big
      everything is.  This is where relaxation is done.  */
   ldemul_after_allocation ();
+  ld_set_phase (phase);
 
   /* Fix any __start, __stop, .startof. or .sizeof. symbols.  */
   lang_finalize_start_stop ();
@@ -9957,3 +9982,292 @@ lang_print_memory_usage (void)
       printf ("\n");
     }
 }
+
+/* Support for --size-report: a JSON account of what fills each memory
+   region, by input object and by symbol, for tools that track code and
+   data size across builds.  */
+
+static void
+size_report_string (FILE *f, const char *s)
+{
+  putc ('"', f);
+  for (; *s != '\0'; s++)
+    {
+      unsigned char c = *s;
+
+      if (c == '"' || c == '\\')
+	fprintf (f, "\\%c", c);
+      else if (c < 0x20)
+	fprintf (f, "\\u%04x", c);
+      else
+	putc (c, f);
+    }
+  putc ('"', f);
+}
+
+/* Return the number of REGION in lang_memory_region_list, or -1 if
+   REGION is NULL or the default region.  */
+
+static int
+size_report_region_index (lang_memory_region_type *region)
+{
+  lang_memory_region_type *r;
+  int i;
+
+  if (region == NULL
+      || strcmp (region->name_list.name, DEFAULT_MEMORY_REGION) == 0)
+    return -1;
+
+  for (r = lang_memory_region_list, i = 0; r != NULL; r = r->next, i++)
+    if (r == region)
+      return i;
+  return -1;
+}
+
+/* Return true if input section S was removed by --gc-sections.  */
+
+static bool
+size_report_gc_removed (asection *s)
+{
+  return (link_info.gc_sections
+	  && !s->gc_mark
+	  && (s->flags & SEC_ALLOC) != 0
+	  && (s->flags & SEC_EXCLUDE) != 0);
+}
+
+/* Return true if input section S ended up in the output file.  */
+
+static bool
+size_report_kept (asection *s)
+{
+  return ((s->flags & SEC_ALLOC) != 0
+	  && (s->flags & SEC_EXCLUDE) == 0
+	  && s->output_section != NULL
+	  && s->output_section->owner == link_info.output_bfd
+	  && !bfd_is_abs_section (s->output_section));
+}
+
+/* Add the size of input section S to the per region counters USED: once
+   for the region it runs from and, for loadable sections placed with
+   AT>, once more for the region it is loaded into.  */
+
+static void
+size_report_count (asection *s, bfd_size_type *used)
+{
+  lang_output_section_statement_type *os;
+  int vma_index, lma_index;
+
+  os = lang_output_section_get (s->output_section);
+  if (os == NULL)
+    return;
+
+  vma_index = size_report_region_index (os->region);
+  if (vma_index >= 0)
+    used[vma_index] += s->size;
+
+  if ((s->flags & SEC_LOAD) != 0 && os->lma_region != os->region)
+    {
+      lma_index = size_report_region_index (os->lma_region);
+      if (lma_index >= 0 && lma_index != vma_index)
+	used[lma_index] += s->size;
+    }
+}
+
+static void
+size_report_regions (FILE *f, const char *key, bfd_size_type *used,
+		     int nregions)
+{
+  lang_memory_region_type *r;
+  const char *sep = "";
+  int i;
+
+  fprintf (f, "\"%s\": {", key);
+  for (r = lang_memory_region_list, i = 0; i < nregions; r = r->next, i++)
+    if (used[i] != 0)
+      {
+	fputs (sep, f);
+	size_report_string (f, r->name_list.name);
+	fprintf (f, ": %" PRIu64, (uint64_t) used[i]);
+	sep = ", ";
+      }
+  fputs ("}", f);
+}
+
+/* Write the symbols of input file F defined in kept allocated sections,
+   separated from earlier entries by *SEP.  */
+
+static void
+size_report_symbols (FILE *out, lang_input_statement_type *f,
+		     const char **sep)
+{
+  asymbol **syms;
+  long i, count;
+
+  if (!bfd_generic_link_read_symbols (f->the_bfd))
+    return;
+
+  syms = bfd_get_outsymbols (f->the_bfd);
+  count = bfd_get_symcount (f->the_bfd);
+  for (i = 0; i < count; i++)
+    {
+      asymbol *sym = syms[i];
+      asection *s = sym->section;
+      elf_symbol_type *esym;
+      lang_output_section_statement_type *os;
+      bfd_vma value = sym->value;
+      bfd_vma size = 0;
+      int region;
+
+      if ((sym->flags & (BSF_FUNCTION | BSF_OBJECT)) == 0
+	  || (sym->flags & BSF_SECTION_SYM) != 0
+	  || s == NULL)
+	continue;
+
+      esym = elf_symbol_from (sym);
+      if (esym != NULL)
+	{
+	  size = esym->internal_elf_sym.st_size;
+	  /* The contents of a SEC_MERGE section may have been merged
+	     with those of another section, which then holds the
+	     symbol.  */
+	  if (s->sec_info_type == SEC_INFO_TYPE_MERGE)
+	    value = _bfd_elf_rel_local_sym (link_info.output_bfd,
+					    &esym->internal_elf_sym, &s, 0);
+	}
+
+      if (!size_report_kept (s))
+	continue;
+
+      os = lang_output_section_get (s->output_section);
+      region = os != NULL ? size_report_region_index (os->region) : -1;
+
+      fprintf (out, "%s\n    {\"name\": ", *sep);
+      size_report_string (out, bfd_asymbol_name (sym));
+      fputs (", \"object\": ", out);
+      size_report_string (out, bfd_get_filename (f->the_bfd));
+      fputs (", \"section\": ", out);
+      size_report_string (out, s->output_section->name);
+      fputs (", \"region\": ", out);
+      if (region >= 0)
+	size_report_string (out, os->region->name_list.name);
+      else
+	fputs ("null", out);
+      fprintf (out, ", \"address\": %" PRIu64 ", \"size\": %" PRIu64
+	       ", \"global\": %s}",
+	       (uint64_t) (value + s->output_offset + s->output_section->vma),
+	       (uint64_t) size,
+	       (sym->flags & BSF_GLOBAL) != 0 ? "true" : "false");
+      *sep = ",";
+    }
+}
+
+/* Implement --size-report: write the JSON size report to FILENAME.  */
+
+void
+lang_write_size_report (const char *filename)
+{
+  lang_memory_region_type *r;
+  bfd_size_type *used;
+  uint64_t gc_bytes = 0, relax_bytes = 0;
+  unsigned int gc_count = 0;
+  int nregions = 0;
+  const char *sep;
+  FILE *out;
+
+  out = fopen (filename, FOPEN_WT);
+  if (out == NULL)
+    {
+      einfo (_("%P: cannot open size report %s: %E\n"), filename);
+      return;
+    }
+
+  for (r = lang_memory_region_list; r != NULL; r = r->next)
+    nregions++;
+  used = xmalloc (nregions * sizeof (*used));
+
+  fputs ("{\n  \"output\": ", out);
+  size_report_string (out, output_filename);
+
+  fputs (",\n  \"regions\": [", out);
+  sep = "";
+  for (r = lang_memory_region_list; r != NULL; r = r->next)
+    {
+      if (size_report_region_index (r) < 0)
+	continue;
+      fprintf (out, "%s\n    {\"name\": ", sep);
+      size_report_string (out, r->name_list.name);
+      fprintf (out, ", \"origin\": %" PRIu64 ", \"length\": %" PRIu64
+	       ", \"used\": %" PRIu64 "}",
+	       (uint64_t) r->origin, (uint64_t) r->length,
+	       (uint64_t) (r->current - r->origin));
+      sep = ",";
+    }
+
+  fputs ("\n  ],\n  \"objects\": [", out);
+  sep = "";
+  LANG_FOR_EACH_INPUT_STATEMENT (f)
+    {
+      uint64_t obj_gc = 0, obj_relax = 0;
+      asection *s;
+
+      if (f->the_bfd == NULL
+	  || (f->the_bfd->flags & DYNAMIC) != 0
+	  || f->flags.just_syms)
+	continue;
+
+      memset (used, 0, nregions * sizeof (*used));
+      for (s = f->the_bfd->sections; s != NULL; s = s->next)
+	{
+	  if (size_report_gc_removed (s))
+	    {
+	      obj_gc += s->rawsize != 0 ? s->rawsize : s->size;
+	      gc_count++;
+	    }
+	  else if (size_report_kept (s))
+	    {
+	      size_report_count (s, used);
+	      /* Relaxation records the original size in RAWSIZE.  So do
+		 merging and .eh_frame or .stab editing, which set
+		 SEC_INFO_TYPE, so leave those sections out.  */
+	      if (RELAXATION_ENABLED
+		  && s->sec_info_type == SEC_INFO_TYPE_NONE
+		  && (s->flags & SEC_MERGE) == 0
+		  && s->rawsize > s->size)
+		obj_relax += s->rawsize - s->size;
+	    }
+	}
+      gc_bytes += obj_gc;
+      relax_bytes += obj_relax;
+
+      fprintf (out, "%s\n    {\"name\": ", sep);
+      size_report_string (out, bfd_get_filename (f->the_bfd));
+      fputs (", ", out);
+      size_report_regions (out, "regions", used, nregions);
+      fprintf (out, ", \"gc_removed\": %" PRIu64
+	       ", \"relax_removed\": %" PRIu64 "}",
+	       obj_gc, obj_relax);
+      sep = ",";
+    }
+
+  fputs ("\n  ],\n  \"symbols\": [", out);
+  sep = "";
+  LANG_FOR_EACH_INPUT_STATEMENT (input)
+    {
+      if (input->the_bfd == NULL
+	  || (input->the_bfd->flags & DYNAMIC) != 0
+	  || input->flags.just_syms)
+	continue;
+      size_report_symbols (out, input, &sep);
+    }
+
+  fprintf (out, "\n  ],\n  \"gc_sections\": {\"enabled\": %s"
+	   ", \"sections\": %u, \"bytes\": %" PRIu64 "},\n",
+	   link_info.gc_sections ? "true" : "false", gc_count, gc_bytes);
+  fprintf (out, "  \"relaxation\": {\"enabled\": %s, \"bytes\": %" PRIu64
+	   "}\n}\n",
+	   RELAXATION_ENABLED ? "true" : "false", relax_bytes);
+
+  free (used);
+  if (fclose (out) != 0)
+    einfo (_("%P: error writing size report %s: %E\n"), filename);
+}
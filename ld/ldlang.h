@@ -733,6 +733,9 @@ lang_ld_feature (char *);
 extern void
 lang_print_memory_usage (void);
 
+extern void
+lang_write_size_report (const char *);
+
 extern void
 lang_add_gc_name (const char *);
 
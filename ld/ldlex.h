@@ -46,6 +46,8 @@ enum option_values
   OPTION_MAP,
   OPTION_NO_DEMANGLE,
   OPTION_NO_KEEP_MEMORY,
+  OPTION_MMAP_INPUTS,
+  OPTION_NO_MMAP_INPUTS,
   OPTION_NO_WARN_MISMATCH,
   OPTION_NO_WARN_SEARCH_MISMATCH,
   OPTION_NOINHIBIT_EXEC,
@@ -66,6 +68,8 @@ enum option_values
   OPTION_SYMBOLIC,
   OPTION_SYMBOLIC_FUNCTIONS,
   OPTION_TASK_LINK,
+  OPTION_THREADS,
+  OPTION_NO_THREADS,
   OPTION_TBSS,
   OPTION_TDATA,
   OPTION_TTEXT,
@@ -155,6 +159,7 @@ enum option_values
   OPTION_POP_STATE,
   OPTION_DISABLE_MULTIPLE_DEFS_ABS,
   OPTION_PRINT_MEMORY_USAGE,
+  OPTION_SIZE_REPORT,
   OPTION_REQUIRE_DEFINED_SYMBOL,
   OPTION_ORPHAN_HANDLING,
   OPTION_FORCE_GROUP_ALLOCATION,
@@ -50,6 +50,13 @@
 #endif
 
 #include <string.h>
+#include <time.h>
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+#if defined (HAVE_SYS_RESOURCE_H) && defined (HAVE_GETRUSAGE)
+#include <sys/resource.h>
+#endif
 
 #ifndef TARGET_SYSTEM_ROOT
 #define TARGET_SYSTEM_ROOT ""
@@ -96,6 +103,36 @@ ld_config_type config;
 
 sort_type sort_section;
 
+/* Time and memory used by each phase of the link, for --stats.  */
+struct phase_stats
+{
+  /* CPU and wall clock time in microseconds.  */
+  long cpu;
+  uint64_t wall;
+  /* How much the peak resident set size grew, in kilobytes, while this
+     was the current phase.  The peak is for the whole process, so this
+     is not the memory the phase used if an earlier phase used more.  */
+  long rss_growth;
+  bool entered;
+};
+
+static struct phase_stats phases[ld_phase_max];
+static enum ld_phase current_phase = ld_phase_other;
+static long phase_cpu_start;
+static uint64_t phase_wall_start;
+static long phase_rss_start;
+
+/* Counts of what was linked, taken before the output file is
+   closed.  */
+static struct
+{
+  unsigned long files;
+  unsigned long sections;
+  unsigned long relocs;
+  unsigned long symbols;
+  unsigned long output_sections;
+} link_counts;
+
 static const char *get_sysroot
   (int, char **);
 static char *get_emulation
@@ -246,11 +283,246 @@ ld_bfd_error_handler (const char *fmt, va_list ap)
   (*default_bfd_error_handler) (fmt, ap);
 }
 
+/* Return the wall clock time in microseconds.  */
+
+static uint64_t
+wall_time (void)
+{
+#ifdef HAVE_GETTIMEOFDAY
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return (uint64_t) tv.tv_sec * 1000000 + tv.tv_usec;
+#else
+  return (uint64_t) time (NULL) * 1000000;
+#endif
+}
+
+/* Return the peak resident set size of the linker so far, in
+   kilobytes, or zero if it isn't known.  */
+
+static long
+peak_rss (void)
+{
+#if defined (HAVE_SYS_RESOURCE_H) && defined (HAVE_GETRUSAGE)
+  struct rusage ru;
+
+  if (getrusage (RUSAGE_SELF, &ru) == 0)
+#ifdef __APPLE__
+    /* Darwin gives it in bytes.  */
+    return ru.ru_maxrss / 1024;
+#else
+    return ru.ru_maxrss;
+#endif
+#endif
+  return 0;
+}
+
+/* Charge the time since the last change of phase to the current
+   phase.  */
+
+static void
+charge_phase (void)
+{
+  struct phase_stats *ps = &phases[current_phase];
+  long cpu = get_run_time ();
+  uint64_t wall = wall_time ();
+  long rss = peak_rss ();
+
+  ps->cpu += cpu - phase_cpu_start;
+  ps->wall += wall - phase_wall_start;
+  ps->rss_growth += rss - phase_rss_start;
+  ps->entered = true;
+  phase_cpu_start = cpu;
+  phase_wall_start = wall;
+  phase_rss_start = rss;
+}
+
+/* Make PHASE the current phase of the link, and return the phase that
+   was current so that the caller can go back to it.  Time spent in a
+   phase nested inside another is only charged to the inner one.  */
+
+enum ld_phase
+ld_set_phase (enum ld_phase phase)
+{
+  enum ld_phase prev = current_phase;
+
+  if (config.stats && phase != prev)
+    charge_phase ();
+  current_phase = phase;
+  return prev;
+}
+
+/* Count the input files, sections and relocs, the symbols and the
+   output sections of the link.  */
+
+static void
+count_link (void)
+{
+  bfd *ibfd;
+  asection *sec;
+
+  for (ibfd = link_info.input_bfds; ibfd != NULL; ibfd = ibfd->link.next)
+    {
+      link_counts.files++;
+      for (sec = ibfd->sections; sec != NULL; sec = sec->next)
+	{
+	  link_counts.sections++;
+	  link_counts.relocs += sec->reloc_count;
+	}
+    }
+  if (link_info.hash != NULL)
+    link_counts.symbols = link_info.hash->table.count;
+  link_counts.output_sections = bfd_count_sections (link_info.output_bfd);
+}
+
+static const char *const phase_names[ld_phase_max] =
+{
+  "other", "open", "archives", "wildcards", "gc-sections", "merge",
+  "sizing", "relocation", "output"
+};
+
+/* Print the statistics gathered for --stats to stderr, as text or, if
+   --stats=json was given, as a JSON object.  START_CPU and START_WALL
+   are the CPU and wall clock times at which the link started.  */
+
+static void
+print_stats (long start_cpu, uint64_t start_wall)
+{
+  long run_time = get_run_time () - start_cpu;
+  uint64_t wall = wall_time () - start_wall;
+  struct bfd_cache_stats cache_stats;
+  struct bfd_merge_stats merge_stats;
+  const char *sep;
+  int i;
+
+  charge_phase ();
+  bfd_cache_get_stats (&cache_stats);
+  bfd_merge_get_stats (&merge_stats);
+
+  fflush (stdout);
+  if (config.stats_json)
+    {
+      fprintf (stderr, "{\"cpu\": %ld.%06ld, \"wall\": %" PRIu64 ".%06" PRIu64
+	       ", \"peak_rss\": %ld,\n",
+	       run_time / 1000000, run_time % 1000000,
+	       wall / 1000000, wall % 1000000, peak_rss ());
+      fprintf (stderr, " \"phases\": [");
+      sep = "";
+      for (i = 0; i < ld_phase_max; i++)
+	{
+	  struct phase_stats *ps = &phases[i];
+
+	  if (!ps->entered)
+	    continue;
+	  fprintf (stderr, "%s\n  {\"name\": \"%s\", \"cpu\": %ld.%06ld, "
+		   "\"wall\": %" PRIu64 ".%06" PRIu64 ", \"rss_growth\": %ld}",
+		   sep, phase_names[i],
+		   ps->cpu / 1000000, ps->cpu % 1000000,
+		   ps->wall / 1000000, ps->wall % 1000000, ps->rss_growth);
+	  sep = ",";
+	}
+      fprintf (stderr, "],\n");
+      fprintf (stderr, " \"counts\": {\"files\": %lu, \"sections\": %lu, "
+	       "\"relocs\": %lu, \"symbols\": %lu, "
+	       "\"output_sections\": %lu},\n",
+	       link_counts.files, link_counts.sections, link_counts.relocs,
+	       link_counts.symbols, link_counts.output_sections);
+      fprintf (stderr, " \"file_cache\": {\"opened\": %lu, "
+	       "\"reopened\": %lu, \"evicted\": %lu, \"mapped\": %lu, "
+	       "\"mapped_bytes\": %" PRIu64 ", \"mapped_reads\": %lu, "
+	       "\"file_reads\": %lu},\n",
+	       cache_stats.opens, cache_stats.reopens, cache_stats.evictions,
+	       cache_stats.maps, cache_stats.mapped_bytes,
+	       cache_stats.mapped_reads, cache_stats.file_reads);
+      fprintf (stderr, " \"merge\": {\"sections\": %lu, \"blobs\": %lu, "
+	       "\"unique\": %lu, \"input_bytes\": %" PRIu64 ", "
+	       "\"output_bytes\": %" PRIu64 ", \"threads\": %u, "
+	       "\"read\": %" PRIu64 ".%06" PRIu64 ", "
+	       "\"hash\": %" PRIu64 ".%06" PRIu64 ", "
+	       "\"insert\": %" PRIu64 ".%06" PRIu64 ", "
+	       "\"layout\": %" PRIu64 ".%06" PRIu64 "}}\n",
+	       merge_stats.sections, merge_stats.blobs, merge_stats.unique,
+	       merge_stats.input_bytes, merge_stats.output_bytes,
+	       merge_stats.threads,
+	       merge_stats.read_time / 1000000,
+	       merge_stats.read_time % 1000000,
+	       merge_stats.hash_time / 1000000,
+	       merge_stats.hash_time % 1000000,
+	       merge_stats.insert_time / 1000000,
+	       merge_stats.insert_time % 1000000,
+	       merge_stats.layout_time / 1000000,
+	       merge_stats.layout_time % 1000000);
+      fflush (stderr);
+      return;
+    }
+
+  fprintf (stderr, _("%s: total time in link: %ld.%06ld\n"),
+	   program_name, run_time / 1000000, run_time % 1000000);
+  fprintf (stderr, _("%s: wall clock time: %" PRIu64 ".%06" PRIu64
+		     ", peak RSS: %ld KiB\n"),
+	   program_name, wall / 1000000, wall % 1000000, peak_rss ());
+  for (i = 0; i < ld_phase_max; i++)
+    {
+      struct phase_stats *ps = &phases[i];
+
+      if (!ps->entered)
+	continue;
+      fprintf (stderr, _("%s: phase %s: %ld.%06ld cpu, %" PRIu64 ".%06"
+			 PRIu64 " wall, peak RSS grew %ld KiB\n"),
+	       program_name, phase_names[i],
+	       ps->cpu / 1000000, ps->cpu % 1000000,
+	       ps->wall / 1000000, ps->wall % 1000000, ps->rss_growth);
+    }
+  fprintf (stderr, _("%s: %lu input files, %lu input sections, %lu relocs, "
+		     "%lu symbols, %lu output sections\n"),
+	   program_name, link_counts.files, link_counts.sections,
+	   link_counts.relocs, link_counts.symbols,
+	   link_counts.output_sections);
+  fprintf (stderr, _("%s: file cache: %lu opened, %lu reopened, "
+		     "%lu closed to make room\n"),
+	   program_name, cache_stats.opens, cache_stats.reopens,
+	   cache_stats.evictions);
+  fprintf (stderr, _("%s: file cache: %lu mapped (%" PRIu64 " bytes), "
+		     "%lu reads from mappings, %lu from files\n"),
+	   program_name, cache_stats.maps, cache_stats.mapped_bytes,
+	   cache_stats.mapped_reads, cache_stats.file_reads);
+  if (merge_stats.sections != 0)
+    {
+      fprintf (stderr, _("%s: merge: %lu sections, %lu strings or "
+			 "constants, %lu kept, %" PRIu64 " bytes in, %"
+			 PRIu64 " bytes out, %u threads\n"),
+	       program_name, merge_stats.sections, merge_stats.blobs,
+	       merge_stats.unique, merge_stats.input_bytes,
+	       merge_stats.output_bytes, merge_stats.threads);
+      fprintf (stderr, _("%s: merge time: read %" PRIu64 ".%06" PRIu64
+			 ", hash %" PRIu64 ".%06" PRIu64
+			 ", insert %" PRIu64 ".%06" PRIu64
+			 ", layout %" PRIu64 ".%06" PRIu64 "\n"),
+	       program_name,
+	       merge_stats.read_time / 1000000,
+	       merge_stats.read_time % 1000000,
+	       merge_stats.hash_time / 1000000,
+	       merge_stats.hash_time % 1000000,
+	       merge_stats.insert_time / 1000000,
+	       merge_stats.insert_time % 1000000,
+	       merge_stats.layout_time / 1000000,
+	       merge_stats.layout_time % 1000000);
+    }
+  fflush (stderr);
+}
+
 int
 main (int argc, char **argv)
 {
   char *emulation;
+  enum ld_phase phase;
   long start_time = get_run_time ();
+  uint64_t start_wall = wall_time ();
+
+  phase_cpu_start = start_time;
+  phase_wall_start = start_wall;
+  phase_rss_start = peak_rss ();
 
 #ifdef HAVE_LC_MESSAGES
   setlocale (LC_MESSAGES, "");
@@ -374,6 +646,13 @@ main (int argc, char **argv)
   lang_has_input_file = false;
   parse_args (argc, argv);
 
+  /* Most of every input file is read, some parts more than once, so
+     --mmap-inputs has the bfd cache map input files rather than read
+     them.  It is off by default, since a file truncated during the
+     link then kills ld with SIGBUS instead of giving a read error.  */
+  if (config.mmap_inputs)
+    bfd_cache_set_mmap (true);
+
   if (config.hash_table_size != 0)
     bfd_hash_set_default_size (config.hash_table_size);
 
@@ -525,7 +804,9 @@ main (int argc, char **argv)
   link_info.output_bfd->flags
     |= flags & bfd_applicable_file_flags (link_info.output_bfd);
 
+  phase = ld_set_phase (ld_phase_reloc);
   ldwrite ();
+  ld_set_phase (phase);
 
   if (config.map_file != NULL)
     lang_map ();
@@ -535,6 +816,8 @@ main (int argc, char **argv)
     check_nocrossrefs ();
   if (command_line.print_memory_usage)
     lang_print_memory_usage ();
+  if (config.size_report_file != NULL)
+    lang_write_size_report (config.size_report_file);
 #if 0
   {
     struct bfd_link_hash_entry *h;
@@ -564,9 +847,14 @@ main (int argc, char **argv)
   else
     {
       bfd *obfd = link_info.output_bfd;
+
+      if (config.stats)
+	count_link ();
       link_info.output_bfd = NULL;
+      phase = ld_set_phase (ld_phase_write);
       if (!bfd_close (obfd))
 	einfo (_("%F%P: %s: final close failed: %E\n"), output_filename);
+      ld_set_phase (phase);
 
       /* If the --force-exe-suffix is enabled, and we're making an
 	 executable file and it doesn't end in .exe, copy it to one
@@ -616,14 +904,7 @@ main (int argc, char **argv)
     }
 
   if (config.stats)
-    {
-      long run_time = get_run_time () - start_time;
-
-      fflush (stdout);
-      fprintf (stderr, _("%s: total time in link: %ld.%06ld\n"),
-	       program_name, run_time / 1000000, run_time % 1000000);
-      fflush (stderr);
-    }
+    print_stats (start_time, start_wall);
 
   /* Prevent ld_cleanup from deleting the output file.  */
   output_filename = NULL;
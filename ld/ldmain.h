@@ -57,6 +57,30 @@ extern char *error_handling_script;
 #define ENABLE_RELAXATION		\
   do { link_info.disable_target_specific_optimizations = 0; } while (0)
 
+/* Phases of the link whose time and memory use --stats reports.  */
+enum ld_phase
+{
+  ld_phase_other,
+  /* Opening input files and loading their symbols.  */
+  ld_phase_open,
+  /* Searching archives, including loading the members pulled in.  */
+  ld_phase_archive,
+  /* Matching input sections to the wildcards of the linker script.  */
+  ld_phase_wild,
+  ld_phase_gc,
+  /* Merging SEC_MERGE sections.  */
+  ld_phase_merge,
+  /* Sizing sections and relaxation.  */
+  ld_phase_size,
+  /* Relocating and writing section contents.  */
+  ld_phase_reloc,
+  /* Writing the rest of the output file and closing it.  */
+  ld_phase_write,
+  ld_phase_max
+};
+
+extern enum ld_phase ld_set_phase (enum ld_phase);
+
 extern void add_ysym (const char *);
 extern void add_wrap (const char *);
 extern void add_ignoresym (struct bfd_link_info *, const char *);
@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <limits.h>
 #include "safe-ctype.h"
 #include "getopt.h"
 #include "bfdlink.h"
@@ -388,6 +389,11 @@ static const struct ld_option ld_options[] =
     '\0', NULL, N_("Do not demangle symbol names"), TWO_DASHES },
   { {"no-keep-memory", no_argument, NULL, OPTION_NO_KEEP_MEMORY},
     '\0', NULL, N_("Use less memory and more disk I/O"), TWO_DASHES },
+  { {"mmap-inputs", no_argument, NULL, OPTION_MMAP_INPUTS},
+    '\0', NULL, N_("Map input files into memory to read them"), TWO_DASHES },
+  { {"no-mmap-inputs", no_argument, NULL, OPTION_NO_MMAP_INPUTS},
+    '\0', NULL, N_("Read input files without mapping them (default)"),
+    TWO_DASHES },
   { {"no-undefined", no_argument, NULL, OPTION_NO_UNDEFINED},
     '\0', NULL, N_("Do not allow unresolved references in object files"),
     TWO_DASHES },
@@ -493,12 +499,20 @@ static const struct ld_option ld_options[] =
   { {"split-by-reloc", optional_argument, NULL, OPTION_SPLIT_BY_RELOC},
     '\0', N_("[=COUNT]"), N_("Split output sections every COUNT relocs"),
     TWO_DASHES },
-  { {"stats", no_argument, NULL, OPTION_STATS},
-    '\0', NULL, N_("Print memory usage statistics"), TWO_DASHES },
+  { {"stats", optional_argument, NULL, OPTION_STATS},
+    '\0', N_("[=FORMAT]"),
+    N_("Print time and memory usage statistics, as text or json"),
+    TWO_DASHES },
   { {"target-help", no_argument, NULL, OPTION_TARGET_HELP},
     '\0', NULL, N_("Display target specific options"), TWO_DASHES },
   { {"task-link", required_argument, NULL, OPTION_TASK_LINK},
     '\0', N_("SYMBOL"), N_("Do task level linking"), TWO_DASHES },
+  { {"threads", optional_argument, NULL, OPTION_THREADS},
+    '\0', N_("[=COUNT]"),
+    N_("Relocate debugging sections and merge strings on up to COUNT threads"),
+    TWO_DASHES },
+  { {"no-threads", no_argument, NULL, OPTION_NO_THREADS},
+    '\0', NULL, N_("Do not use threads (default)"), TWO_DASHES },
   { {"traditional-format", no_argument, NULL, OPTION_TRADITIONAL_FORMAT},
     '\0', NULL, N_("Use same format as native linker"), TWO_DASHES },
   { {"section-start", required_argument, NULL, OPTION_SECTION_START},
@@ -615,6 +629,10 @@ static const struct ld_option ld_options[] =
     TWO_DASHES },
   { {"print-memory-usage", no_argument, NULL, OPTION_PRINT_MEMORY_USAGE},
     '\0', NULL, N_("Report target memory usage"), TWO_DASHES },
+  { {"size-report", required_argument, NULL, OPTION_SIZE_REPORT},
+    '\0', N_("FILE"),
+    N_("Write memory usage per region, object and symbol to FILE as JSON"),
+    TWO_DASHES },
   { {"orphan-handling", required_argument, NULL, OPTION_ORPHAN_HANDLING},
     '\0', N_("=MODE"), N_("Control how orphan sections are handled."),
     TWO_DASHES },
@@ -1091,6 +1109,12 @@ parse_args (unsigned argc, char **argv)
 	case OPTION_NO_KEEP_MEMORY:
 	  link_info.keep_memory = false;
 	  break;
+	case OPTION_MMAP_INPUTS:
+	  config.mmap_inputs = true;
+	  break;
+	case OPTION_NO_MMAP_INPUTS:
+	  config.mmap_inputs = false;
+	  break;
 	case OPTION_NO_UNDEFINED:
 	  link_info.unresolved_syms_in_objects = RM_DIAGNOSE;
 	  break;
@@ -1396,6 +1420,12 @@ parse_args (unsigned argc, char **argv)
 	  break;
 	case OPTION_STATS:
 	  config.stats = true;
+	  if (optarg == NULL || strcmp (optarg, "text") == 0)
+	    config.stats_json = false;
+	  else if (strcmp (optarg, "json") == 0)
+	    config.stats_json = true;
+	  else
+	    einfo (_("%F%P: invalid --stats format: %s\n"), optarg);
 	  break;
 	case OPTION_NO_SYMBOLIC:
 	  opt_symbolic = symbolic_unset;
@@ -1675,6 +1705,25 @@ parse_args (unsigned argc, char **argv)
 	case OPTION_SPARE_DYNAMIC_TAGS:
 	  link_info.spare_dynamic_tags = strtoul (optarg, NULL, 0);
 	  break;
+	case OPTION_THREADS:
+	  if (optarg != NULL)
+	    {
+	      char *end;
+	      unsigned long val;
+
+	      errno = 0;
+	      val = strtoul (optarg, &end, 0);
+	      if (*end != '\0' || val == 0 || val > UINT_MAX || errno != 0)
+		einfo (_("%F%P: invalid number `%s'\n"), optarg);
+	      link_info.threads = val;
+	    }
+	  else
+	    /* One for each processor.  */
+	    link_info.threads = (unsigned int) -1;
+	  break;
+	case OPTION_NO_THREADS:
+	  link_info.threads = 0;
+	  break;
 	case OPTION_SPLIT_BY_RELOC:
 	  if (optarg != NULL)
 	    config.split_by_reloc = strtoul (optarg, NULL, 0);
@@ -1790,6 +1839,10 @@ parse_args (unsigned argc, char **argv)
 	  command_line.print_memory_usage = true;
 	  break;
 
+	case OPTION_SIZE_REPORT:
+	  config.size_report_file = optarg;
+	  break;
+
 	case OPTION_ORPHAN_HANDLING:
 	  if (strcasecmp (optarg, "place") == 0)
 	    config.orphan_handling = orphan_handling_place;
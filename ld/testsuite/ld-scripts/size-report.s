@@ -0,0 +1,25 @@
+	.text
+	.globl	func
+	.type	func, %function
+func:
+	.space	16
+	.size	func, 16
+
+	.data
+	.globl	var
+	.type	var, %object
+var:
+	.space	8
+	.size	var, 8
+
+	.section .rodata.str1.1,"aMS",%progbits,1
+	.globl	msg1
+	.type	msg1, %object
+msg1:
+	.string	"hello"
+	.size	msg1, 6
+	.globl	msg2
+	.type	msg2, %object
+msg2:
+	.string	"hello"
+	.size	msg2, 6
@@ -0,0 +1,13 @@
+MEMORY
+{
+  ROM (RX) : ORIGIN = 0x1000, LENGTH = 1K
+  RAM (W)  : ORIGIN = 0x100000, LENGTH = 1K
+}
+
+SECTIONS
+{
+  .text : { *(.text) } > ROM
+  .rodata : { *(.rodata.*) } > ROM
+  .data : { *(.data) } > RAM AT> ROM
+  /DISCARD/ : { *(.*) }
+}
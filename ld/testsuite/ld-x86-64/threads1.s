@@ -0,0 +1,17 @@
+	.globl	big
+	big = 0x123456789
+
+	.text
+	.globl	_start
+	.type	_start, @function
+_start:
+	call	func
+	ret
+	.size	_start, .-_start
+
+	.section	.debug_info,"",@progbits
+	.quad	_start
+	.long	_start
+	.quad	func
+	.section	.debug_line,"",@progbits
+	.quad	_start
@@ -0,0 +1,13 @@
+	.text
+	.globl	func
+	.type	func, @function
+func:
+	ret
+	.size	func, .-func
+
+	.section	.debug_info,"",@progbits
+	.quad	func
+	.long	big
+	.quad	_start
+	.section	.debug_line,"",@progbits
+	.quad	func
@@ -792,6 +792,11 @@ disassemble_free_target (struct disassemble_info *info)
 #ifdef ARCH_rs6000
     case bfd_arch_rs6000:
       break;
+#endif
+#ifdef ARCH_stm8
+    case bfd_arch_stm8:
+      disassemble_free_stm8 (info);
+      break;
 #endif
     }
 
@@ -23,7 +23,7 @@
 
 #include "sysdep.h"
 
-#include "dis-asm.h"
+#include "disassemble.h"
 #include "libiberty.h"
 #include "opintl.h"
 #include <assert.h>
@@ -36,8 +36,6 @@
 #define PIY 0x91
 #define PWSP 0x72
 
-static const char *COMMENT_START = "0x";
-
 typedef struct
 {
   char comment[40];
@@ -66,6 +64,357 @@ fetch_data (unsigned char *buf, bfd_vma addr, disassemble_info *info, int n)
   return -1;
 }
 
+/* One named address in the symbol index.  */
+struct stm8_symbol_entry
+{
+  bfd_vma addr;
+  const char *name;
+  bool global;
+};
+
+/* All indexed symbols of one section, sorted by address.  */
+struct stm8_symbol_section
+{
+  asection *sec;
+  bfd_vma start;
+  bfd_vma end;
+  /* The highest END of this and all earlier sections of the index.  */
+  bfd_vma max_end;
+  struct stm8_symbol_entry *entries;
+  size_t count;
+};
+
+/* Absolute symbols (peripheral registers and the like) are kept apart
+   and only ever match exactly.  The other sections are sorted by start
+   address, so both lookups are binary searches.  */
+struct stm8_symbol_index
+{
+  struct stm8_symbol_section abs;
+  struct stm8_symbol_section *sections;
+  size_t count;
+};
+
+/* Per disassembly run state hung off INFO->private_data.  */
+struct stm8_private
+{
+  /* Index used for operand comments, NULL if there is none.  */
+  const struct stm8_symbol_index *index;
+  /* Set when INDEX was built from INFO->symtab and must be freed here.  */
+  struct stm8_symbol_index *owned_index;
+  /* Set when the caller supplied INDEX with
+     stm8_disassemble_set_symbol_index.  */
+  bool shared_index;
+};
+
+static int
+compare_symbol_entries (const void *a, const void *b)
+{
+  const struct stm8_symbol_entry *ea = a;
+  const struct stm8_symbol_entry *eb = b;
+
+  if (ea->addr != eb->addr)
+    return ea->addr < eb->addr ? -1 : 1;
+
+  /* Prefer global names over local labels at the same address.  */
+  if (ea->global != eb->global)
+    return ea->global ? -1 : 1;
+
+  return strcmp (ea->name, eb->name);
+}
+
+static int
+compare_symbol_sections (const void *a, const void *b)
+{
+  const struct stm8_symbol_section *sa = a;
+  const struct stm8_symbol_section *sb = b;
+
+  if (sa->start != sb->start)
+    return sa->start < sb->start ? -1 : 1;
+  if (sa->end != sb->end)
+    return sa->end < sb->end ? -1 : 1;
+  return 0;
+}
+
+/* qsort comparison of symbols by section, so that each section's
+   symbols end up next to each other.  */
+
+static int
+compare_symbols_by_section (const void *a, const void *b)
+{
+  const asymbol *sa = *(const asymbol **) a;
+  const asymbol *sb = *(const asymbol **) b;
+
+  if (sa->section->id != sb->section->id)
+    return sa->section->id < sb->section->id ? -1 : 1;
+  return 0;
+}
+
+static bool
+stm8_symbol_indexable (asymbol *sym)
+{
+  if (sym == NULL || sym->name == NULL || sym->name[0] == 0)
+    return false;
+
+  if ((sym->flags & (BSF_SECTION_SYM | BSF_FILE | BSF_DEBUGGING)) != 0)
+    return false;
+
+  if (sym->section == NULL || bfd_is_und_section (sym->section)
+      || bfd_is_com_section (sym->section))
+    return false;
+
+  return true;
+}
+
+/* Fill S with the COUNT symbols in SYMS, all of one section.  */
+
+static void
+stm8_symbol_section_fill (struct stm8_symbol_section *s, asymbol **syms,
+                          size_t count)
+{
+  s->sec = syms[0]->section;
+  if (!bfd_is_abs_section (s->sec))
+    {
+      s->start = bfd_section_vma (s->sec);
+      s->end = s->start + bfd_section_size (s->sec);
+    }
+  s->entries = xmalloc (count * sizeof (struct stm8_symbol_entry));
+  s->count = count;
+  for (size_t i = 0; i < count; i++)
+    {
+      struct stm8_symbol_entry *e = &s->entries[i];
+
+      e->addr = bfd_asymbol_value (syms[i]);
+      e->name = bfd_asymbol_name (syms[i]);
+      e->global = (syms[i]->flags & (BSF_GLOBAL | BSF_WEAK)) != 0;
+    }
+  qsort (s->entries, count, sizeof (struct stm8_symbol_entry),
+         compare_symbol_entries);
+}
+
+/* Build an address index over the COUNT symbols in SYMS.  SYMS need not
+   be sorted, and may come from several BFDs.  The index keeps pointers
+   to the symbol names, so the owner of the symbols must outlive it.  */
+
+struct stm8_symbol_index *
+stm8_symbol_index_create (asymbol **syms, long count)
+{
+  struct stm8_symbol_index *index = xcalloc (1, sizeof (*index));
+  asymbol **sorted;
+  size_t n = 0, nsec = 0;
+
+  if (count <= 0)
+    return index;
+
+  /* Group the symbols worth naming by section.  */
+  sorted = xmalloc (count * sizeof (*sorted));
+  for (long i = 0; i < count; i++)
+    if (stm8_symbol_indexable (syms[i]))
+      sorted[n++] = syms[i];
+  qsort (sorted, n, sizeof (*sorted), compare_symbols_by_section);
+
+  for (size_t i = 0; i < n; i++)
+    if (i == 0 || sorted[i]->section != sorted[i - 1]->section)
+      nsec++;
+  index->sections = xmalloc ((nsec + 1) * sizeof (*index->sections));
+
+  for (size_t i = 0, j; i < n; i = j)
+    {
+      struct stm8_symbol_section *s;
+
+      for (j = i + 1; j < n && sorted[j]->section == sorted[i]->section; j++)
+        ;
+      if (bfd_is_abs_section (sorted[i]->section))
+        s = &index->abs;
+      else
+        s = &index->sections[index->count++];
+      memset (s, 0, sizeof (*s));
+      stm8_symbol_section_fill (s, sorted + i, j - i);
+    }
+  free (sorted);
+
+  qsort (index->sections, index->count, sizeof (*index->sections),
+         compare_symbol_sections);
+  for (size_t i = 0; i < index->count; i++)
+    {
+      struct stm8_symbol_section *s = &index->sections[i];
+
+      s->max_end = s->end;
+      if (i > 0 && s->max_end < index->sections[i - 1].max_end)
+        s->max_end = index->sections[i - 1].max_end;
+    }
+
+  return index;
+}
+
+void
+stm8_symbol_index_free (struct stm8_symbol_index *index)
+{
+  if (index == NULL)
+    return;
+
+  for (size_t i = 0; i < index->count; i++)
+    free (index->sections[i].entries);
+  free (index->sections);
+  free (index->abs.entries);
+  free (index);
+}
+
+/* Return the last entry of S at or below ADDR, or NULL.  */
+
+static const struct stm8_symbol_entry *
+stm8_symbol_section_lookup (const struct stm8_symbol_section *s, bfd_vma addr)
+{
+  size_t lo = 0;
+  size_t hi = s->count;
+
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+
+      if (s->entries[mid].addr <= addr)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  if (lo == 0)
+    return NULL;
+
+  /* Step back to the preferred (first sorted) name at that address.  */
+  lo--;
+  while (lo > 0 && s->entries[lo - 1].addr == s->entries[lo].addr)
+    lo--;
+
+  return &s->entries[lo];
+}
+
+/* Find the name for ADDR: an exact absolute symbol wins, otherwise the
+   closest preceding symbol of the section containing ADDR.  */
+
+static const struct stm8_symbol_entry *
+stm8_symbol_index_lookup (const struct stm8_symbol_index *index, bfd_vma addr)
+{
+  const struct stm8_symbol_entry *best;
+  size_t lo = 0;
+  size_t hi = index->count;
+
+  best = stm8_symbol_section_lookup (&index->abs, addr);
+  if (best != NULL && best->addr == addr)
+    return best;
+  best = NULL;
+
+  /* Find the sections starting at or below ADDR...  */
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+
+      if (index->sections[mid].start <= addr)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  /* ...and take the closest symbol of those that contain it.  Sections
+     don't usually overlap, so this rarely looks at more than one.  */
+  while (lo-- > 0 && index->sections[lo].max_end > addr)
+    {
+      const struct stm8_symbol_section *s = &index->sections[lo];
+      const struct stm8_symbol_entry *e;
+
+      if (addr >= s->end)
+        continue;
+
+      e = stm8_symbol_section_lookup (s, addr);
+      if (e != NULL && (best == NULL || e->addr > best->addr))
+        best = e;
+    }
+
+  return best;
+}
+
+static struct stm8_private *
+stm8_get_private (disassemble_info *info)
+{
+  struct stm8_private *priv = info->private_data;
+
+  if (priv == NULL)
+    {
+      priv = xcalloc (1, sizeof (*priv));
+      info->private_data = priv;
+    }
+
+  /* objdump hands over its symbol table only after the target was
+     initialised, so build the index on first use.  */
+  if (priv->index == NULL && !priv->shared_index
+      && info->symtab != NULL && info->symtab_size > 0)
+    {
+      priv->owned_index
+          = stm8_symbol_index_create (info->symtab, info->symtab_size);
+      priv->index = priv->owned_index;
+    }
+
+  return priv;
+}
+
+void
+stm8_disassemble_set_symbol_index (disassemble_info *info,
+                                   const struct stm8_symbol_index *index)
+{
+  struct stm8_private *priv = info->private_data;
+
+  if (priv == NULL)
+    {
+      priv = xcalloc (1, sizeof (*priv));
+      info->private_data = priv;
+    }
+
+  priv->index = index;
+  priv->shared_index = true;
+}
+
+void
+disassemble_free_stm8 (disassemble_info *info)
+{
+  struct stm8_private *priv = info->private_data;
+
+  if (priv != NULL)
+    stm8_symbol_index_free (priv->owned_index);
+}
+
+/* Print ADDR for an operand comment as 0xADDR <SYMBOL+OFFSET>, naming it
+   from the symbol index, and fall back to the caller's
+   print_address_func for addresses the index has no name for.  An index
+   shared by the caller, as GDB does, comes with a print_address_func
+   which gives the address the 0x prefix itself; objdump's does not.  */
+
+static void
+stm8_print_symbol_addr (bfd_vma addr, disassemble_info *info)
+{
+  const struct stm8_private *priv = info->private_data;
+  const struct stm8_symbol_entry *e = NULL;
+
+  if (priv != NULL && priv->index != NULL)
+    e = stm8_symbol_index_lookup (priv->index, addr);
+
+  info->fprintf_func (info->stream, " ");
+  if (e == NULL)
+    {
+      if (priv == NULL || !priv->shared_index)
+        info->fprintf_styled_func (info->stream, dis_style_address, "0x");
+      info->print_address_func (addr, info);
+      return;
+    }
+
+  info->fprintf_styled_func (info->stream, dis_style_address, "0x%" PRIx64,
+                             (uint64_t)addr);
+  info->fprintf_styled_func (info->stream, dis_style_text, " <");
+  info->fprintf_styled_func (info->stream, dis_style_symbol, "%s", e->name);
+  if (addr != e->addr)
+    info->fprintf_styled_func (info->stream, dis_style_address_offset,
+                               "+0x%" PRIx64, (uint64_t)(addr - e->addr));
+  info->fprintf_styled_func (info->stream, dis_style_text, ">");
+}
+
 int
 stm8_operands (disas_op_element_t *element, bfd_vma addr_w_offset,
                disassemble_info *info, uint32_t *print_offset,
@@ -139,7 +488,6 @@ stm8_operands (disas_op_element_t *element, bfd_vma addr_w_offset,
 
       element->is_symbol = true;
       element->symbol_addr = (addr_w_offset - 1) + (char)buf[0];
-      strcpy (element->comment, COMMENT_START);
       return 1;
     case ST8_SHORTMEM:
       print (info->stream, dis_style_address, "$0x%2.2x", buf[0]);
@@ -210,7 +558,6 @@ stm8_operands (disas_op_element_t *element, bfd_vma addr_w_offset,
 
       element->is_symbol = true;
       element->symbol_addr = val;
-      strcpy (element->comment, COMMENT_START);
       return 2;
     case ST8_LONGOFF_X:
       val = (buf[0] << 8) + buf[1];
@@ -287,7 +634,6 @@ stm8_operands (disas_op_element_t *element, bfd_vma addr_w_offset,
 
       element->is_symbol = true;
       element->symbol_addr = val;
-      strcpy (element->comment, COMMENT_START);
       return 3;
     case ST8_EXTOFF_X:
       val = (buf[0] << 16) + (buf[1] << 8) + buf[2];
@@ -396,7 +742,7 @@ stm8_dis (bfd_vma addr, disassemble_info *info, unsigned int op, int *cmd_len)
         info->fprintf_func (info->stream, " %s", element->comment);
 
       if (element->is_symbol)
-        info->print_address_func (element->symbol_addr, info);
+        stm8_print_symbol_addr (element->symbol_addr, info);
     }
 
   return 0;
@@ -410,6 +756,8 @@ print_insn_stm8 (bfd_vma addr, disassemble_info *info)
 
   int cmd_len = 0;
 
+  stm8_get_private (info);
+
   if (fetch_data (buffer, addr, info, 1) != 0)
     return -1;
 
@@ -1296,7 +1296,7 @@ get_extended_cycles (SIM_CPU *cpu)
 /* We can't re-use sim_events_time() because the CYCLES registers may be
    written/cleared/reset/stopped/started at any time by software.  */
 static void
-cycles_inc (SIM_CPU *cpu, bu32 inc)
+cycles_inc (SIM_CPU *cpu, bu64 inc)
 {
   bu64 cycles;
   bu32 cycles2;
@@ -1832,9 +1832,6 @@ decode_ProgCtrl_0 (SIM_CPU *cpu, bu16 iw0, bu32 pc)
     }
   else if (prgfunc == 2 && poprnd == 0)
     {
-      SIM_DESC sd = CPU_STATE (cpu);
-      sim_events *events = STATE_EVENTS (sd);
-
       PROFILE_COUNT_INSN (cpu, pc, BFIN_INSN_ProgCtrl_sync);
       /* XXX: in supervisor mode, utilizes wake up sources
          in user mode, it's a NOP ...  */
@@ -1843,11 +1840,9 @@ decode_ProgCtrl_0 (SIM_CPU *cpu, bu16 iw0, bu32 pc)
       if (PARALLEL_GROUP != BFIN_PARALLEL_NONE)
 	illegal_instruction_combination (cpu);
 
-      /* Timewarp !  */
-      if (events->queue)
-	CYCLE_DELAY = events->time_from_event;
-      else
-	abort (); /* XXX: Should this ever happen ?  */
+      /* Timewarp !  Jump straight to the next event rather than
+	 ticking through the idle cycles one at a time.  */
+      cycles_inc (cpu, sim_events_idle (CPU_STATE (cpu)));
     }
   else if (prgfunc == 2 && poprnd == 3)
     {
@@ -220,11 +220,13 @@ do_counter_event (struct hw *me,
       HW_TRACE ((me, "timer expired"));
       counter->start = hw_event_queue_time (me);
       hw_port_event (me, TIMER_PORT, 1);
-      hw_event_queue_schedule (me, counter->delta, do_counter_event, counter);
+      counter->handler = hw_event_queue_schedule (me, counter->delta,
+						  do_counter_event, counter);
     }
   else
     {
       HW_TRACE ((me, "countdown expired"));
+      counter->handler = NULL;
       counter->delta = 0;
       hw_port_event (me, COUNTDOWN_PORT, 1);
     }
@@ -285,7 +287,8 @@ do_counter_write (struct hw *me,
   counter->start = hw_event_queue_time (me);
   HW_TRACE ((me, "write - %s %ld", reg, (long) counter->delta));
   if (counter->delta > 0)
-    hw_event_queue_schedule (me, counter->delta, do_counter_event, counter);
+    counter->handler = hw_event_queue_schedule (me, counter->delta,
+						do_counter_event, counter);
 }
 
 
@@ -85,6 +85,10 @@ sim_core_uninstall (SIM_DESC sd)
       free (tbd);
     }
     core->common.map[map].first = NULL;
+    free (core->common.map[map].segments);
+    core->common.map[map].segments = NULL;
+    core->common.map[map].nr_segments = 0;
+    core->common.map[map].last = NULL;
   }
 }
 #endif
@@ -167,6 +171,129 @@ new_sim_core_mapping (SIM_DESC sd,
 #endif
 
 
+#if EXTERN_SIM_CORE_P
+static int
+sim_core_compare_words (const void *a, const void *b)
+{
+  unsigned_word wa = *(const unsigned_word *) a;
+  unsigned_word wb = *(const unsigned_word *) b;
+  return (wa > wb) - (wa < wb);
+}
+
+/* Rebuild the segment index of ACCESS_MAP from its list of mappings.
+
+   The list is searched in order - lower levels first - for the first
+   mapping that covers an address.  Cutting the address space at every
+   mapping's base and end gives ranges over which that answer cannot
+   change, so each range is resolved once here and lookups become a
+   binary search.  Within a level the list is sorted by address and
+   the mappings do not overlap, so resolving a range is itself a binary
+   search of each level in turn.  */
+
+static void
+sim_core_map_index (sim_core_map *access_map)
+{
+  sim_core_mapping *mapping;
+  sim_core_mapping **mappings;
+  unsigned *levels;
+  unsigned_word *points;
+  unsigned nr_levels = 0;
+  unsigned nr_points = 0;
+  unsigned nr_unique;
+  unsigned nr_mappings = 0;
+  unsigned i;
+
+  free (access_map->segments);
+  access_map->segments = NULL;
+  access_map->nr_segments = 0;
+  access_map->last = NULL;
+
+  for (mapping = access_map->first; mapping != NULL; mapping = mapping->next)
+    nr_mappings++;
+  if (nr_mappings == 0)
+    return;
+
+  /* MAPPINGS in list order; level L occupies LEVELS[L]..LEVELS[L+1].  */
+  mappings = NZALLOC (sim_core_mapping *, nr_mappings);
+  levels = NZALLOC (unsigned, nr_mappings + 1);
+  points = NZALLOC (unsigned_word, 2 * nr_mappings);
+  for (mapping = access_map->first, i = 0;
+       mapping != NULL;
+       mapping = mapping->next, i++)
+    {
+      mappings[i] = mapping;
+      if (i == 0 || mappings[i - 1]->level != mapping->level)
+	levels[nr_levels++] = i;
+      points[nr_points++] = mapping->base;
+      if (mapping->bound + 1 != 0)
+	points[nr_points++] = mapping->bound + 1;
+    }
+  levels[nr_levels] = nr_mappings;
+  qsort (points, nr_points, sizeof (*points), sim_core_compare_words);
+
+  /* Mappings that abut or share a base give the same point twice; keep
+     one copy so each range ends just before the next distinct point.  */
+  for (i = 1, nr_unique = 1; i < nr_points; i++)
+    if (points[i] != points[nr_unique - 1])
+      points[nr_unique++] = points[i];
+  nr_points = nr_unique;
+
+  access_map->segments = NZALLOC (sim_core_segment, nr_points);
+  for (i = 0; i < nr_points; i++)
+    {
+      sim_core_segment *prev;
+      unsigned_word base = points[i];
+      unsigned_word bound;
+      unsigned level;
+
+      bound = (i + 1 < nr_points ? points[i + 1] - 1 : (unsigned_word) -1);
+
+      mapping = NULL;
+      for (level = 0; level < nr_levels && mapping == NULL; level++)
+	{
+	  unsigned lo = levels[level];
+	  unsigned hi = levels[level + 1];
+	  unsigned start = lo;
+	  while (lo < hi)
+	    {
+	      unsigned mid = lo + (hi - lo) / 2;
+	      if (mappings[mid]->base <= base)
+		lo = mid + 1;
+	      else
+		hi = mid;
+	    }
+	  /* Prefer an earlier mapping that also reaches BASE.  */
+	  while (lo > start && base <= mappings[lo - 1]->bound)
+	    {
+	      mapping = mappings[lo - 1];
+	      lo--;
+	    }
+	}
+      if (mapping == NULL)
+	continue;
+
+      /* Merge with the previous segment when nothing splits them.  */
+      prev = (access_map->nr_segments > 0
+	      ? &access_map->segments[access_map->nr_segments - 1]
+	      : NULL);
+      if (prev != NULL && prev->mapping == mapping
+	  && prev->bound + 1 == base)
+	prev->bound = bound;
+      else
+	{
+	  access_map->segments[access_map->nr_segments].base = base;
+	  access_map->segments[access_map->nr_segments].bound = bound;
+	  access_map->segments[access_map->nr_segments].mapping = mapping;
+	  access_map->nr_segments++;
+	}
+    }
+  free (points);
+  free (levels);
+  free (mappings);
+}
+#endif
+
+
 #if EXTERN_SIM_CORE_P
 static void
 sim_core_map_attach (SIM_DESC sd,
@@ -245,6 +372,8 @@ sim_core_map_attach (SIM_DESC sd,
 					space, addr, nr_bytes, modulo,
 					client, buffer, free_buffer);
   (*last_mapping)->next = next_mapping;
+
+  sim_core_map_index (access_map);
 }
 #endif
 
@@ -382,6 +511,7 @@ sim_core_map_detach (SIM_DESC sd,
 	  if (dead->free_buffer != NULL)
 	    free (dead->free_buffer);
 	  free (dead);
+	  sim_core_map_index (access_map);
 	  return;
 	}
     }
@@ -428,16 +558,48 @@ sim_core_find_mapping (sim_core_common *core,
 		       sim_cpu *cpu, /* abort => cpu != NULL */
 		       sim_cia cia)
 {
-  sim_core_mapping *mapping = core->map[map].first;
+  sim_core_map *access_map = &core->map[map];
+  sim_core_segment *segment = access_map->last;
+  sim_core_mapping *mapping;
   ASSERT ((addr & (nr_bytes - 1)) == 0); /* must be aligned */
   ASSERT ((addr + (nr_bytes - 1)) >= addr); /* must not wrap */
   ASSERT (!abort || cpu != NULL); /* abort needs a non null CPU */
-  while (mapping != NULL)
+
+  /* Accesses tend to stay within one segment; only search the index
+     when they leave the last one.  */
+  if (segment == NULL || addr < segment->base || addr > segment->bound)
     {
-      if (addr >= mapping->base
-	  && (addr + (nr_bytes - 1)) <= mapping->bound)
-	return mapping;
-      mapping = mapping->next;
+      unsigned lo = 0;
+      unsigned hi = access_map->nr_segments;
+      while (lo < hi)
+	{
+	  unsigned mid = lo + (hi - lo) / 2;
+	  if (access_map->segments[mid].base <= addr)
+	    lo = mid + 1;
+	  else
+	    hi = mid;
+	}
+      segment = NULL;
+      if (lo > 0 && addr <= access_map->segments[lo - 1].bound)
+	{
+	  segment = &access_map->segments[lo - 1];
+	  access_map->last = segment;
+	}
+    }
+
+  if (segment != NULL)
+    {
+      /* The segment's mapping is the first to cover ADDR, so no earlier
+	 one can hold the whole access.  If the access runs past its end,
+	 fall back to the later, overlapping mappings.  */
+      mapping = segment->mapping;
+      while (mapping != NULL)
+	{
+	  if (addr >= mapping->base
+	      && (addr + (nr_bytes - 1)) <= mapping->bound)
+	    return mapping;
+	  mapping = mapping->next;
+	}
     }
   if (abort)
     {
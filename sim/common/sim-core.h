@@ -65,9 +65,24 @@ struct _sim_core_mapping {
   sim_core_mapping *next;
 };
 
+/* An address range over which every lookup finds the same mapping.  */
+
+typedef struct _sim_core_segment sim_core_segment;
+struct _sim_core_segment {
+  unsigned_word base;
+  unsigned_word bound;
+  sim_core_mapping *mapping;
+};
+
 typedef struct _sim_core_map sim_core_map;
 struct _sim_core_map {
   sim_core_mapping *first;
+  /* FIRST flattened into sorted, disjoint segments; rebuilt whenever a
+     mapping is attached or detached.  */
+  sim_core_segment *segments;
+  unsigned nr_segments;
+  /* The segment that satisfied the most recent lookup.  */
+  sim_core_segment *last;
 };
 
 
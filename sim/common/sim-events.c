@@ -104,6 +104,10 @@ struct _sim_event {
   uint64_t lb64;
   /* trace info (if any) */
   char *trace;
+  /* timer event - slot in the queue heap (-1 if not queued) and
+     scheduling order, which breaks ties between equal times */
+  int heap_index;
+  uint64_t order;
   /* list */
   sim_event *next;
 };
@@ -154,7 +158,8 @@ do \
 while (0)
 
 
-/* event queue iterator - don't iterate over the held queue. */
+/* watchpoint queue iterator - the timer events are kept in a heap
+   and the held queue is not iterated over. */
 
 #if EXTERN_SIM_EVENTS_P
 static sim_event **
@@ -162,8 +167,6 @@ next_event_queue (SIM_DESC sd,
 		  sim_event **queue)
 {
   if (queue == NULL)
-    return &STATE_EVENTS (sd)->queue;
-  else if (queue == &STATE_EVENTS (sd)->queue)
     return &STATE_EVENTS (sd)->watchpoints;
   else if (queue == &STATE_EVENTS (sd)->watchpoints)
     return &STATE_EVENTS (sd)->watchedpoints;
@@ -247,8 +250,13 @@ sim_events_suspend (SIM_DESC sd)
 static void
 sim_events_uninstall (SIM_DESC sd)
 {
+  sim_events *events = STATE_EVENTS (sd);
   SIM_ASSERT (STATE_MAGIC (sd) == SIM_MAGIC_NUMBER);
   /* FIXME: free buffers, etc. */
+  free (events->queue);
+  events->queue = NULL;
+  events->nr_queued = 0;
+  events->queue_size = 0;
 }
 #endif
 
@@ -281,6 +289,7 @@ sim_events_zalloc (SIM_DESC sd)
       sigprocmask (SIG_SETMASK, &old_mask, NULL);
 #endif
     }
+  new->heap_index = -1;
   return new;
 }
 #endif
@@ -292,6 +301,7 @@ sim_events_free (SIM_DESC sd,
 {
   sim_events *events = STATE_EVENTS (sd);
   dead->next = events->free_list;
+  dead->heap_index = -1;
   events->free_list = dead;
   if (dead->trace != NULL)
     {
@@ -315,6 +325,8 @@ sim_events_init (SIM_DESC sd)
     events->held = NZALLOC (sim_event, MAX_NR_SIGNAL_SIM_EVENTS);
 
   /* drain the normal queues */
+  while (events->nr_queued > 0)
+    sim_events_free (sd, events->queue[--events->nr_queued]);
   {
     sim_event **queue = NULL;
     while ((queue = next_event_queue (sd, queue)) != NULL)
@@ -342,7 +354,7 @@ sim_events_init (SIM_DESC sd)
 
   /* from now on, except when the large-int event is being processed
      the event queue is non empty */
-  SIM_ASSERT (events->queue != NULL);
+  SIM_ASSERT (events->nr_queued > 0);
 
   return SIM_RC_OK;
 }
@@ -392,10 +404,10 @@ update_time_from_event (SIM_DESC sd)
 {
   sim_events *events = STATE_EVENTS (sd);
   int64_t current_time = sim_events_time (sd);
-  if (events->queue != NULL)
+  if (events->nr_queued > 0)
     {
-      events->time_of_event = events->queue->time_of_event;
-      events->time_from_event = (events->queue->time_of_event - current_time);
+      events->time_of_event = events->queue[0]->time_of_event;
+      events->time_from_event = (events->queue[0]->time_of_event - current_time);
     }
   else
     {
@@ -404,12 +416,11 @@ update_time_from_event (SIM_DESC sd)
     }
   if (STRACE_EVENTS_P (sd))
     {
-      sim_event *event;
       int i;
-      for (event = events->queue, i = 0;
-	   event != NULL;
-	   event = event->next, i++)
+      /* in heap order, not time order */
+      for (i = 0; i < events->nr_queued; i++)
 	{
+	  sim_event *event = events->queue[i];
 	  ETRACE ((_ETRACE,
 		   "event time-from-event - "
 		   "time %" PRIi64 ", delta %" PRIi64 " - "
@@ -430,6 +441,93 @@ update_time_from_event (SIM_DESC sd)
 }
 
 
+/* The timer queue is a binary heap: the event at slot I is due no
+   later than those at slots 2I+1 and 2I+2.  Events due at the same
+   time are issued in the order that they were scheduled.  Each event
+   records its slot so that it can be descheduled without a search. */
+
+STATIC_INLINE_SIM_EVENTS\
+(int)
+sim_events_before (const sim_event *a,
+		   const sim_event *b)
+{
+  if (a->time_of_event != b->time_of_event)
+    return a->time_of_event < b->time_of_event;
+  return a->order < b->order;
+}
+
+STATIC_INLINE_SIM_EVENTS\
+(void)
+sim_events_heap_set (sim_events *events,
+		     int slot,
+		     sim_event *event)
+{
+  events->queue[slot] = event;
+  event->heap_index = slot;
+}
+
+STATIC_INLINE_SIM_EVENTS\
+(void)
+sim_events_sift_up (sim_events *events,
+		    int slot)
+{
+  sim_event *event = events->queue[slot];
+  while (slot > 0)
+    {
+      int parent = (slot - 1) / 2;
+      if (!sim_events_before (event, events->queue[parent]))
+	break;
+      sim_events_heap_set (events, slot, events->queue[parent]);
+      slot = parent;
+    }
+  sim_events_heap_set (events, slot, event);
+}
+
+STATIC_INLINE_SIM_EVENTS\
+(void)
+sim_events_sift_down (sim_events *events,
+		      int slot)
+{
+  sim_event *event = events->queue[slot];
+  for (;;)
+    {
+      int child = 2 * slot + 1;
+      if (child >= events->nr_queued)
+	break;
+      if (child + 1 < events->nr_queued
+	  && sim_events_before (events->queue[child + 1],
+				events->queue[child]))
+	child += 1;
+      if (!sim_events_before (events->queue[child], event))
+	break;
+      sim_events_heap_set (events, slot, events->queue[child]);
+      slot = child;
+    }
+  sim_events_heap_set (events, slot, event);
+}
+
+/* Remove the event at SLOT from the timer queue.  */
+
+STATIC_INLINE_SIM_EVENTS\
+(sim_event *)
+sim_events_heap_remove (sim_events *events,
+			int slot)
+{
+  sim_event *dead = events->queue[slot];
+  sim_event *last = events->queue[--events->nr_queued];
+  if (last != dead)
+    {
+      sim_events_heap_set (events, slot, last);
+      if (slot > 0 && sim_events_before (last, events->queue[(slot - 1) / 2]))
+	sim_events_sift_up (events, slot);
+      else
+	sim_events_sift_down (events, slot);
+    }
+  dead->heap_index = -1;
+  return dead;
+}
+
+
 #if EXTERN_SIM_EVENTS_P
 static void
 insert_sim_event (SIM_DESC sd,
@@ -437,8 +535,6 @@ insert_sim_event (SIM_DESC sd,
 		  int64_t delta)
 {
   sim_events *events = STATE_EVENTS (sd);
-  sim_event *curr;
-  sim_event **prev;
   int64_t time_of_event;
 
   if (delta < 0)
@@ -447,22 +543,22 @@ insert_sim_event (SIM_DESC sd,
   /* compute when the event should occur */
   time_of_event = sim_events_time (sd) + delta;
 
-  /* find the queue insertion point - things are time ordered */
-  prev = &events->queue;
-  curr = events->queue;
-  while (curr != NULL && time_of_event >= curr->time_of_event)
+  /* make room for it */
+  if (events->nr_queued == events->queue_size)
     {
-      SIM_ASSERT (curr->next == NULL
-		  || curr->time_of_event <= curr->next->time_of_event);
-      prev = &curr->next;
-      curr = curr->next;
+      events->queue_size = (events->queue_size == 0
+			    ? 64 : 2 * events->queue_size);
+      events->queue = xrealloc (events->queue,
+				events->queue_size * sizeof (sim_event *));
     }
-  SIM_ASSERT (curr == NULL || time_of_event < curr->time_of_event);
 
-  /* insert it */
-  new_event->next = curr;
-  *prev = new_event;
+  /* insert it - the heap keeps things time ordered */
   new_event->time_of_event = time_of_event;
+  new_event->order = events->nr_scheduled++;
+  new_event->next = NULL;
+  events->queue[events->nr_queued] = new_event;
+  events->nr_queued += 1;
+  sim_events_sift_up (events, events->nr_queued - 1);
 
   /* adjust the time until the first event */
   update_time_from_event (sd);
@@ -827,6 +923,28 @@ sim_events_deschedule (SIM_DESC sd,
 {
   sim_events *events = STATE_EVENTS (sd);
   sim_event *to_remove = (sim_event*)event_to_remove;
+  if (event_to_remove != NULL
+      && to_remove->heap_index >= 0
+      && to_remove->heap_index < events->nr_queued
+      && events->queue[to_remove->heap_index] == to_remove)
+    {
+      sim_event *dead = sim_events_heap_remove (events,
+						to_remove->heap_index);
+      ETRACE ((_ETRACE,
+	       "event/watch descheduled at %" PRIi64 " - "
+	       "tag %p - time %" PRIi64 ", handler %p, data %p%s%s\n",
+	       sim_events_time (sd),
+	       event_to_remove,
+	       dead->time_of_event,
+	       dead->handler,
+	       dead->data,
+	       (dead->trace != NULL) ? ", " : "",
+	       (dead->trace != NULL) ? dead->trace : ""));
+      sim_events_free (sd, dead);
+      update_time_from_event (sd);
+      SIM_ASSERT ((events->time_from_event >= 0) == (events->nr_queued > 0));
+      return;
+    }
   if (event_to_remove != NULL)
     {
       sim_event **queue = NULL;
@@ -851,8 +969,6 @@ sim_events_deschedule (SIM_DESC sd,
 		       (dead->trace != NULL) ? ", " : "",
 		       (dead->trace != NULL) ? dead->trace : ""));
 	      sim_events_free (sd, dead);
-	      update_time_from_event (sd);
-	      SIM_ASSERT ((events->time_from_event >= 0) == (events->queue != NULL));
 	      return;
 	    }
 	}
@@ -1117,6 +1233,29 @@ sim_events_slip (SIM_DESC sd,
 }
 
 
+INLINE_SIM_EVENTS\
+(int64_t)
+sim_events_idle (SIM_DESC sd)
+{
+  sim_events *events = STATE_EVENTS (sd);
+  int64_t skip;
+
+  /* Watchpoints have to be polled on every tick, and anything else
+     pending has to be seen to before time moves on */
+  if (events->work_pending
+      || events->time_from_event <= 0)
+    return 0;
+
+  skip = events->time_from_event;
+  ETRACE ((_ETRACE,
+	   "event idle at %" PRIi64 " - skipping %" PRIi64 " ticks\n",
+	   sim_events_time (sd),
+	   skip));
+  events->time_from_event = 0;
+  return skip;
+}
+
+
 INLINE_SIM_EVENTS\
 (void)
 sim_events_preprocess (SIM_DESC sd,
@@ -1220,13 +1359,13 @@ sim_events_process (SIM_DESC sd)
 
   /* consume all events for this or earlier times.  Be careful to
      allow an event to appear/disappear under our feet */
-  while (events->queue->time_of_event <
+  while (events->nr_queued > 0
+	 && events->queue[0]->time_of_event <
 	 (event_time + events->nr_ticks_to_process))
     {
-      sim_event *to_do = events->queue;
+      sim_event *to_do = sim_events_heap_remove (events, 0);
       sim_event_handler *handler = to_do->handler;
       void *data = to_do->data;
-      events->queue = to_do->next;
       update_time_from_event (sd);
       ETRACE ((_ETRACE,
 	       "event issued at %" PRIi64 " - tag %p - handler %p, data %p%s%s\n",
@@ -1248,7 +1387,7 @@ sim_events_process (SIM_DESC sd)
 
   /* advance the time */
   SIM_ASSERT (events->time_from_event >= events->nr_ticks_to_process);
-  SIM_ASSERT (events->queue != NULL); /* always poll event */
+  SIM_ASSERT (events->nr_queued > 0); /* always poll event */
   events->time_from_event -= events->nr_ticks_to_process;
 
   /* this round of processing complete */
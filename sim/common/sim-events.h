@@ -80,7 +80,12 @@ typedef struct _sim_event sim_event;
 typedef struct _sim_events sim_events;
 struct _sim_events {
   int nr_ticks_to_process;
-  sim_event *queue;
+  /* timer events, as a binary heap ordered by time and then by the
+     order in which they were scheduled */
+  sim_event **queue;
+  int nr_queued;
+  int queue_size;
+  uint64_t nr_scheduled;
   sim_event *watchpoints;
   sim_event *watchedpoints;
   sim_event *free_list;
@@ -261,6 +266,18 @@ INLINE_SIM_EVENTS\
  int slip);
 
 
+/* Declare the simulator idle until the next event, e.g. because the
+   cpu is waiting for an interrupt.  The clock is advanced so that the
+   next call to sim_events_tick*() processes the next event, and the
+   number of ticks skipped is returned.  Nothing is skipped while
+   asynchronous work or watchpoints are pending.  With several cpus
+   this should only be called once all of them are idle. */
+
+INLINE_SIM_EVENTS\
+(int64_t) sim_events_idle
+(SIM_DESC sd);
+
+
 /* Progress time such that an event shall occur upon the next call to
    sim_events tick */
 
@@ -80,6 +80,17 @@ sim_core_trace_M (sim_cpu *cpu,
   const char *transfer = (type == read_transfer ? "read" : "write");
   const char *direction = (type == read_transfer ? "->" : "<-");
 
+  if (TRACE_BINARY_P (cpu))
+    {
+#if (M == 16)
+      trace_binary_core (cpu, type, map, addr,
+			 V8_16 (val, 1), V8_16 (val, 0), nr_bytes);
+#else
+      trace_binary_core (cpu, type, map, addr, val, 0, nr_bytes);
+#endif
+      return;
+    }
+
   if (TRACE_DEBUG_P (cpu))
     trace_printf (CPU_STATE (cpu), cpu, "sim-n-core.h:%d: ", line_nr);
 
@@ -40,6 +40,8 @@ static unsigned int _profile_stub;
 # define PROFILE_PC_START(p) _profile_stub
 # define PROFILE_PC_END(p) _profile_stub
 # define PROFILE_INSN_COUNT(p) &_profile_stub
+static char *_profile_gmon_stub;
+# define PROFILE_PC_GMON(p) _profile_gmon_stub
 #endif
 
 #define COMMAS(n) sim_add_commas (comma_buf, sizeof (comma_buf), (n))
@@ -59,6 +61,7 @@ enum {
   OPTION_PROFILE_PC,
   OPTION_PROFILE_PC_RANGE,
   OPTION_PROFILE_PC_GRANULARITY,
+  OPTION_PROFILE_PC_GMON,
   OPTION_PROFILE_RANGE,
   OPTION_PROFILE_FUNCTION
 };
@@ -103,6 +106,9 @@ static const OPTION profile_options[] = {
   { {"profile-pc-range", required_argument, NULL, OPTION_PROFILE_PC_RANGE},
       '\0', "BASE,BOUND", "Specify PC profiling address range",
       profile_option_handler, NULL },
+  { {"profile-pc-gmon", required_argument, NULL, OPTION_PROFILE_PC_GMON},
+      '\0', "FILE NAME", "Specify PC profiling gprof data file (default gmon.out)",
+      profile_option_handler, NULL },
 
 #ifdef SIM_HAVE_ADDR_RANGE
   { {"profile-range", required_argument, NULL, OPTION_PROFILE_RANGE},
@@ -392,6 +398,21 @@ profile_option_handler (SIM_DESC sd,
 	sim_io_eprintf (sd, "PC profiling not compiled in, `--profile-pc-granularity' ignored\n");
       break;
 
+    case OPTION_PROFILE_PC_GMON:
+      if (WITH_PROFILE_PC_P)
+	{
+	  for (cpu_nr = 0; cpu_nr < MAX_NR_PROCESSORS; ++cpu_nr)
+	    {
+	      PROFILE_DATA *data = CPU_PROFILE_DATA (STATE_CPU (sd, cpu_nr));
+	      free (PROFILE_PC_GMON (data));
+	      PROFILE_PC_GMON (data) = xstrdup (arg);
+	      CPU_PROFILE_FLAGS (STATE_CPU (sd, cpu_nr))[PROFILE_PC_IDX] = 1;
+	    }
+	}
+      else
+	sim_io_eprintf (sd, "PC profiling not compiled in, `--profile-pc-gmon' ignored\n");
+      break;
+
     case OPTION_PROFILE_PC_RANGE:
       if (WITH_PROFILE_PC_P)
 	{
@@ -501,6 +522,10 @@ profile_pc_cleanup (SIM_DESC sd)
       if (PROFILE_PC_EVENT (data) != NULL)
 	sim_events_deschedule (sd, PROFILE_PC_EVENT (data));
       PROFILE_PC_EVENT (data) = NULL;
+      free (PROFILE_PC_ARCS (data));
+      PROFILE_PC_ARCS (data) = NULL;
+      PROFILE_PC_NR_ARCS (data) = 0;
+      PROFILE_PC_ARCS_SIZE (data) = 0;
     }
 }
 
@@ -508,7 +533,76 @@ profile_pc_cleanup (SIM_DESC sd)
 static void
 profile_pc_uninstall (SIM_DESC sd)
 {
+  int n;
+
   profile_pc_cleanup (sd);
+  for (n = 0; n < MAX_NR_PROCESSORS; n++)
+    {
+      PROFILE_DATA *data = CPU_PROFILE_DATA (STATE_CPU (sd, n));
+      free (PROFILE_PC_GMON (data));
+      PROFILE_PC_GMON (data) = NULL;
+    }
+}
+
+/* A call graph arc.  A COUNT of zero marks an empty hash table slot.  */
+
+struct profile_pc_arc
+{
+  address_word from;
+  address_word to;
+  unsigned long count;
+};
+
+static unsigned
+profile_pc_arc_hash (address_word from, address_word to)
+{
+  return (unsigned) (from * 31 + to) * 2654435761u;
+}
+
+void
+sim_profile_pc_call (sim_cpu *cpu, address_word from, address_word to)
+{
+  PROFILE_DATA *profile = CPU_PROFILE_DATA (cpu);
+  struct profile_pc_arc *arcs = PROFILE_PC_ARCS (profile);
+  unsigned mask;
+  unsigned i;
+
+  /* Keep the table no more than half full.  */
+  if ((PROFILE_PC_NR_ARCS (profile) + 1) * 2 > PROFILE_PC_ARCS_SIZE (profile))
+    {
+      unsigned old_size = PROFILE_PC_ARCS_SIZE (profile);
+      unsigned new_size = old_size ? old_size * 2 : 256;
+      struct profile_pc_arc *old_arcs = arcs;
+
+      arcs = NZALLOC (struct profile_pc_arc, new_size);
+      mask = new_size - 1;
+      for (i = 0; i < old_size; i++)
+	if (old_arcs[i].count != 0)
+	  {
+	    unsigned j = profile_pc_arc_hash (old_arcs[i].from,
+					      old_arcs[i].to) & mask;
+	    while (arcs[j].count != 0)
+	      j = (j + 1) & mask;
+	    arcs[j] = old_arcs[i];
+	  }
+      free (old_arcs);
+      PROFILE_PC_ARCS (profile) = arcs;
+      PROFILE_PC_ARCS_SIZE (profile) = new_size;
+    }
+
+  mask = PROFILE_PC_ARCS_SIZE (profile) - 1;
+  for (i = profile_pc_arc_hash (from, to) & mask;
+       arcs[i].count != 0;
+       i = (i + 1) & mask)
+    if (arcs[i].from == from && arcs[i].to == to)
+      {
+	arcs[i].count += 1;
+	return;
+      }
+  arcs[i].from = from;
+  arcs[i].to = to;
+  arcs[i].count = 1;
+  PROFILE_PC_NR_ARCS (profile) += 1;
 }
 
 static void
@@ -610,6 +704,116 @@ profile_pc_init (SIM_DESC sd)
   return SIM_RC_OK;
 }
 
+/* Write VAL to F as an NR_BYTES target byte order integer.  */
+
+static int
+profile_gmon_put (FILE *f, uint64_t val, int nr_bytes)
+{
+  unsigned char buf[8];
+  int i;
+
+  for (i = 0; i < nr_bytes; i++)
+    {
+      int shift = (CURRENT_TARGET_BYTE_ORDER == BFD_ENDIAN_BIG
+		   ? nr_bytes - 1 - i : i) * 8;
+      buf[i] = val >> shift;
+    }
+  return fwrite (buf, nr_bytes, 1, f) == 1;
+}
+
+/* Dump the histogram and call graph arcs of CPU in the gprof gmon.out
+   format: a header, one histogram record and then one record per arc,
+   all in target byte order.  Addresses are as wide as gprof expects
+   them to be for the program.  */
+
+static void
+profile_pc_write_gmon (sim_cpu *cpu)
+{
+  SIM_DESC sd = CPU_STATE (cpu);
+  PROFILE_DATA *profile = CPU_PROFILE_DATA (cpu);
+  struct profile_pc_arc *arcs = PROFILE_PC_ARCS (profile);
+  const char *name = PROFILE_PC_GMON (profile);
+  char *cpu_name = NULL;
+  bfd *abfd = STATE_PROG_BFD (sd);
+  int addr_size = -1;
+  uint64_t high_pc;
+  unsigned long rate;
+  FILE *pf;
+  unsigned i;
+  int ok;
+
+  if (name == NULL)
+    name = "gmon.out";
+  /* Keep the profiles of multiple cpus apart.  */
+  if (CPU_INDEX (cpu) != 0)
+    name = cpu_name = xasprintf ("%s.%d", name, CPU_INDEX (cpu));
+
+  if (abfd != NULL)
+    {
+      addr_size = bfd_get_arch_size (abfd);
+      if (addr_size == -1)
+	addr_size = bfd_arch_bits_per_address (abfd);
+    }
+  addr_size = (addr_size == 64 ? 8 : 4);
+
+  pf = fopen (name, "wb");
+  if (pf == NULL)
+    {
+      sim_io_eprintf (sd, "Failed to open \"%s\" profile file\n", name);
+      free (cpu_name);
+      return;
+    }
+
+  /* A sample is taken every PROFILE_PC_FREQ cycles, so gprof can only
+     report seconds when the cpu frequency is known.  */
+  rate = 1;
+  if (PROFILE_CPU_FREQ (profile) >= PROFILE_PC_FREQ (profile))
+    rate = PROFILE_CPU_FREQ (profile) / PROFILE_PC_FREQ (profile);
+  high_pc = ((uint64_t) PROFILE_PC_START (profile)
+	     + ((uint64_t) PROFILE_PC_BUCKET_SIZE (profile)
+		* PROFILE_PC_NR_BUCKETS (profile)));
+
+  /* The header: magic, version and padding.  */
+  ok = (fwrite ("gmon", 4, 1, pf) == 1
+	&& profile_gmon_put (pf, 1, 4)
+	&& profile_gmon_put (pf, 0, 4)
+	&& profile_gmon_put (pf, 0, 4)
+	&& profile_gmon_put (pf, 0, 4));
+
+  /* The histogram.  */
+  ok = (ok
+	&& profile_gmon_put (pf, 0, 1)
+	&& profile_gmon_put (pf, PROFILE_PC_START (profile), addr_size)
+	&& profile_gmon_put (pf, high_pc, addr_size)
+	&& profile_gmon_put (pf, PROFILE_PC_NR_BUCKETS (profile), 4)
+	&& profile_gmon_put (pf, rate, 4)
+	&& fwrite (rate > 1
+		   ? "seconds\0\0\0\0\0\0\0\0s" : "samples\0\0\0\0\0\0\0\0#",
+		   16, 1, pf) == 1);
+  for (i = 0; ok && i < PROFILE_PC_NR_BUCKETS (profile); i++)
+    {
+      unsigned sample = PROFILE_PC_COUNT (profile) [i];
+
+      if (sample > 0xffff)
+	sample = 0xffff;
+      ok = profile_gmon_put (pf, sample, 2);
+    }
+
+  /* The call graph.  */
+  for (i = 0; ok && i < PROFILE_PC_ARCS_SIZE (profile); i++)
+    if (arcs[i].count != 0)
+      ok = (profile_gmon_put (pf, 1, 1)
+	    && profile_gmon_put (pf, arcs[i].from, addr_size)
+	    && profile_gmon_put (pf, arcs[i].to, addr_size)
+	    && profile_gmon_put (pf, (arcs[i].count > 0xffffffff
+				      ? 0xffffffff : arcs[i].count), 4));
+
+  if (!ok)
+    sim_io_eprintf (sd, "Failed to write to \"%s\" profile file\n", name);
+  fclose (pf);
+  free (cpu_name);
+}
+
 static void
 profile_print_pc (sim_cpu *cpu, bool verbose)
 {
@@ -643,6 +847,8 @@ profile_print_pc (sim_cpu *cpu, bool verbose)
 		  COMMAS (PROFILE_PC_NR_BUCKETS (profile)));
   profile_printf (sd, cpu, "  Frequency: %s cycles per sample\n",
 		  COMMAS (PROFILE_PC_FREQ (profile)));
+  profile_printf (sd, cpu, "  Call arcs: %s\n",
+		  COMMAS (PROFILE_PC_NR_ARCS (profile)));
 
   if (PROFILE_PC_END (profile) != 0)
     profile_printf (sd, cpu, "  Range: 0x%lx 0x%lx\n",
@@ -678,59 +884,7 @@ profile_print_pc (sim_cpu *cpu, bool verbose)
 	}
     }
 
-  /* dump the histogram to the file "gmon.out" using BSD's gprof file
-     format */
-  /* Since a profile data file is in the native format of the host on
-     which the profile is being, endian issues are not considered in
-     the code below. */
-  /* FIXME: Is this the best place for this code? */
-  {
-    FILE *pf = fopen ("gmon.out", "wb");
-
-    if (pf == NULL)
-      sim_io_eprintf (sd, "Failed to open \"gmon.out\" profile file\n");
-    else
-      {
-	int ok;
-	/* FIXME: what if the target has a 64 bit PC? */
-	uint32_t header[3];
-	unsigned loop;
-	if (PROFILE_PC_END (profile) != 0)
-	  {
-	    header[0] = PROFILE_PC_START (profile);
-	    header[1] = PROFILE_PC_END (profile);
-	  }
-	else
-	  {
-	    header[0] = 0;
-	    header[1] = 0;
-	  }
-	/* size of sample buffer (+ header) */
-	header[2] = PROFILE_PC_NR_BUCKETS (profile) * 2 + sizeof (header);
-
-	/* Header must be written out in target byte order.  */
-	H2T (header[0]);
-	H2T (header[1]);
-	H2T (header[2]);
-
-	ok = fwrite (&header, sizeof (header), 1, pf);
-	for (loop = 0;
-	     ok && (loop < PROFILE_PC_NR_BUCKETS (profile));
-	     loop++)
-	  {
-	    int16_t sample;
-	    if (PROFILE_PC_COUNT (profile) [loop] >= 0xffff)
-	      sample = 0xffff;
-	    else
-	      sample = PROFILE_PC_COUNT (profile) [loop];
- 	    H2T (sample);
-	    ok = fwrite (&sample, sizeof (sample), 1, pf);
-	  }
-	if (ok == 0)
-	  sim_io_eprintf (sd, "Failed to write to \"gmon.out\" profile file\n");
-	fclose (pf);
-      }
-  }
+  profile_pc_write_gmon (cpu);
 
   profile_printf (sd, cpu, "\n");
 }
@@ -200,6 +200,17 @@ typedef struct {
 #define PROFILE_PC_COUNT(p) ((p)->profile_pc_count)
   sim_event *profile_pc_event;
 #define PROFILE_PC_EVENT(p) ((p)->profile_pc_event)
+  /* Call graph arcs, counted while PC profiling is on, in an open
+     addressed hash table of PROFILE_PC_ARCS_SIZE entries.  */
+  struct profile_pc_arc *profile_pc_arcs;
+#define PROFILE_PC_ARCS(p) ((p)->profile_pc_arcs)
+  unsigned profile_pc_nr_arcs;
+#define PROFILE_PC_NR_ARCS(p) ((p)->profile_pc_nr_arcs)
+  unsigned profile_pc_arcs_size;
+#define PROFILE_PC_ARCS_SIZE(p) ((p)->profile_pc_arcs_size)
+  /* The gprof data file the histogram and arcs are written to.  */
+  char *profile_pc_gmon;
+#define PROFILE_PC_GMON(p) ((p)->profile_pc_gmon)
 #endif
 
   /* Profile output goes to this or stderr if NULL.
@@ -280,6 +291,20 @@ do { \
 #define PROFILE_COUNT_CORE(cpu, addr, size, map)
 #endif /* ! core */
 
+/* Count a call from FROM, the address of the call instruction, to the
+   function at TO.  Ports invoke this from their call instructions so
+   that the gprof data file includes a call graph.  */
+
+#if WITH_PROFILE_PC_P
+#define PROFILE_COUNT_CALL(cpu, from, to) \
+do { \
+  if (PROFILE_PC_P (cpu)) \
+    sim_profile_pc_call (cpu, from, to); \
+} while (0)
+#else
+#define PROFILE_COUNT_CALL(cpu, from, to)
+#endif /* ! pc */
+
 #if WITH_PROFILE_MODEL_P
 #define PROFILE_BRANCH_TAKEN(cpu) \
 do { \
@@ -299,5 +324,6 @@ do { \
 /* Misc. utilities.  */
 
 extern void sim_profile_print_bar (SIM_DESC, sim_cpu *, unsigned int, unsigned int, unsigned int);
+extern void sim_profile_pc_call (sim_cpu *, address_word, address_word);
 
 #endif /* SIM_PROFILE_H */
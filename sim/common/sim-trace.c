@@ -52,6 +52,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
 #define SIZE_LINE_NUMBER 4
 #endif
 
+#ifndef SIZE_BINARY_BUFFER
+#define SIZE_BINARY_BUFFER (4 * 1024 * 1024)
+#endif
+
 static MODULE_INIT_FN trace_init;
 static MODULE_UNINSTALL_FN trace_uninstall;
 
@@ -77,7 +81,9 @@ enum {
   OPTION_TRACE_FILE,
   OPTION_TRACE_VPU,
   OPTION_TRACE_SYSCALL,
-  OPTION_TRACE_REGISTER
+  OPTION_TRACE_REGISTER,
+  OPTION_TRACE_BINARY,
+  OPTION_TRACE_BINARY_DUMP
 };
 
 static const OPTION trace_options[] =
@@ -150,6 +156,12 @@ static const OPTION trace_options[] =
   { {"trace-file", required_argument, NULL, OPTION_TRACE_FILE},
       '\0', "FILE NAME", "Specify tracing output file",
       trace_option_handler, NULL },
+  { {"trace-binary", required_argument, NULL, OPTION_TRACE_BINARY},
+      '\0', "FILE NAME", "Write a compact binary instruction and core trace to FILE",
+      trace_option_handler, NULL },
+  { {"trace-binary-dump", required_argument, NULL, OPTION_TRACE_BINARY_DUMP},
+      '\0', "FILE NAME", "Disassemble and print a binary trace, then exit",
+      trace_option_handler, NULL },
   { {NULL, no_argument, NULL, 0}, '\0', NULL, NULL, NULL, NULL }
 };
 
@@ -228,6 +240,349 @@ set_trace_option (SIM_DESC sd, const char *name, int idx, const char *arg)
   return set_trace_option_mask (sd, name, 1 << idx, arg);
 }
 
+/* Binary tracing.
+
+   --trace-binary replaces the text trace with a stream of fixed layout
+   records collected in a large buffer, which is only written out when
+   full or when the simulator is shut down.  Each instruction started by
+   trace_prefix becomes one record, and the core accesses it makes follow
+   it.  The stream is:
+
+     "SIMTRACE" version:1 big-endian:1 name-length:1 name:name-length
+
+   where NAME is the bfd architecture name of the program, followed by
+   any number of:
+
+     TRACE_BINARY_INSN   cpu:1 nr-bytes:1 pc:8 opcode:nr-bytes
+     TRACE_BINARY_READ   map:1 nr-bytes:1 addr:8 value:nr-bytes
+     TRACE_BINARY_WRITE  map:1 nr-bytes:1 addr:8 value:nr-bytes
+
+   Addresses and values are little-endian.  The opcode bytes are in
+   target order, as fetched through exec_map.  --trace-binary-dump
+   prints such a stream back, disassembling each instruction.  */
+
+#define TRACE_BINARY_VERSION 1
+
+enum {
+  TRACE_BINARY_INSN = 1,
+  TRACE_BINARY_READ,
+  TRACE_BINARY_WRITE
+};
+
+/* The largest opcode kept for an instruction.  */
+#define TRACE_BINARY_MAX_INSN 16
+
+struct trace_binary {
+  FILE *file;
+  int header_p;
+  unsigned char *buf;
+  size_t used;
+
+  /* The instruction whose opcode bytes are still being fetched.  */
+  int insn_p;
+  int insn_cpu;
+  uint64_t insn_pc;
+  int insn_size;
+  unsigned char insn[TRACE_BINARY_MAX_INSN];
+};
+
+static void
+trace_binary_flush (SIM_DESC sd, struct trace_binary *tb)
+{
+  if (!tb->header_p)
+    {
+      const char *name = "";
+      unsigned char head[11];
+      size_t len;
+
+      if (STATE_ARCHITECTURE (sd) != NULL)
+	name = STATE_ARCHITECTURE (sd)->printable_name;
+      len = strlen (name);
+      if (len > 255)
+	len = 255;
+      memcpy (head, "SIMTRACE", 8);
+      head[8] = TRACE_BINARY_VERSION;
+      head[9] = CURRENT_TARGET_BYTE_ORDER == BFD_ENDIAN_BIG;
+      head[10] = len;
+      fwrite (head, 1, sizeof (head), tb->file);
+      fwrite (name, 1, len, tb->file);
+      tb->header_p = 1;
+    }
+
+  if (tb->used != 0
+      && fwrite (tb->buf, 1, tb->used, tb->file) != tb->used)
+    sim_io_eprintf (sd, "Unable to write binary trace\n");
+  tb->used = 0;
+}
+
+/* Append a record of TAG, A, B, the 64 bit VALUE and then NR_BYTES of
+   DATA to the trace buffer.  */
+
+static void
+trace_binary_record (SIM_DESC sd, struct trace_binary *tb, int tag,
+		     int a, int b, uint64_t value,
+		     const unsigned char *data, int nr_bytes)
+{
+  unsigned char *p;
+  int i;
+
+  if (tb->used + 11 + nr_bytes > SIZE_BINARY_BUFFER)
+    trace_binary_flush (sd, tb);
+
+  p = tb->buf + tb->used;
+  p[0] = tag;
+  p[1] = a;
+  p[2] = b;
+  for (i = 0; i < 8; i++)
+    p[3 + i] = value >> (i * 8);
+  memcpy (p + 11, data, nr_bytes);
+  tb->used += 11 + nr_bytes;
+}
+
+/* Write out the instruction being fetched, if any.  */
+
+static void
+trace_binary_end_insn (SIM_DESC sd, struct trace_binary *tb)
+{
+  if (!tb->insn_p)
+    return;
+  trace_binary_record (sd, tb, TRACE_BINARY_INSN, tb->insn_cpu,
+		       tb->insn_size, tb->insn_pc, tb->insn, tb->insn_size);
+  tb->insn_p = 0;
+}
+
+/* Write out everything still buffered for TB and close its file.  */
+
+static void
+trace_binary_finish (SIM_DESC sd, struct trace_binary *tb)
+{
+  trace_binary_end_insn (sd, tb);
+  trace_binary_flush (sd, tb);
+  fclose (tb->file);
+}
+
+static SIM_RC
+trace_binary_open (SIM_DESC sd, const char *name)
+{
+  struct trace_binary *tb;
+  FILE *f;
+  int n;
+
+  f = fopen (name, "wb");
+  if (f == NULL)
+    {
+      sim_io_eprintf (sd, "Unable to open binary trace file `%s'\n", name);
+      return SIM_RC_FAIL;
+    }
+
+  tb = TRACE_BINARY (STATE_TRACE_DATA (sd));
+  if (tb != NULL)
+    trace_binary_finish (sd, tb);
+  else
+    {
+      tb = ZALLOC (struct trace_binary);
+      tb->buf = xmalloc (SIZE_BINARY_BUFFER);
+    }
+  tb->file = f;
+  tb->header_p = 0;
+  tb->used = 0;
+  tb->insn_p = 0;
+
+  TRACE_BINARY (STATE_TRACE_DATA (sd)) = tb;
+  for (n = 0; n < MAX_NR_PROCESSORS; ++n)
+    TRACE_BINARY (CPU_TRACE_DATA (STATE_CPU (sd, n))) = tb;
+
+  /* The records come from the core tracing hooks.  */
+  return set_trace_option (sd, "-binary", TRACE_CORE_IDX, NULL);
+}
+
+static void
+trace_binary_close (SIM_DESC sd)
+{
+  struct trace_binary *tb = TRACE_BINARY (STATE_TRACE_DATA (sd));
+  int n;
+
+  if (tb == NULL)
+    return;
+
+  trace_binary_finish (sd, tb);
+  free (tb->buf);
+  free (tb);
+
+  TRACE_BINARY (STATE_TRACE_DATA (sd)) = NULL;
+  for (n = 0; n < MAX_NR_PROCESSORS; ++n)
+    TRACE_BINARY (CPU_TRACE_DATA (STATE_CPU (sd, n))) = NULL;
+}
+
+void
+trace_binary_core (sim_cpu *cpu,
+		   transfer_type type,
+		   unsigned map,
+		   address_word addr,
+		   uint64_t lo,
+		   uint64_t hi,
+		   int nr_bytes)
+{
+  SIM_DESC sd = CPU_STATE (cpu);
+  struct trace_binary *tb = TRACE_BINARY (CPU_TRACE_DATA (cpu));
+  unsigned char value[16];
+  int i;
+
+  for (i = 0; i < nr_bytes; i++)
+    value[i] = (i < 8 ? lo >> (i * 8) : hi >> ((i - 8) * 8));
+
+  if (map == exec_map && type == read_transfer && tb->insn_p
+      && tb->insn_size + nr_bytes <= TRACE_BINARY_MAX_INSN)
+    {
+      /* Opcode bytes are kept in target order so that they can be fed
+	 straight to the disassembler.  */
+      for (i = 0; i < nr_bytes; i++)
+	tb->insn[tb->insn_size + i]
+	  = (CURRENT_TARGET_BYTE_ORDER == BFD_ENDIAN_BIG
+	     ? value[nr_bytes - 1 - i] : value[i]);
+      tb->insn_size += nr_bytes;
+      return;
+    }
+
+  trace_binary_end_insn (sd, tb);
+  trace_binary_record (sd, tb,
+		       type == read_transfer
+		       ? TRACE_BINARY_READ : TRACE_BINARY_WRITE,
+		       map, nr_bytes, addr, value, nr_bytes);
+}
+
+static int ATTRIBUTE_PRINTF (2, 3)
+dump_printf (SIM_DESC sd, const char *fmt, ...)
+{
+  va_list ap;
+  va_start (ap, fmt);
+  sim_io_vprintf (sd, fmt, ap);
+  va_end (ap);
+  return 0;
+}
+
+static int ATTRIBUTE_PRINTF (3, 4)
+dump_styled_printf (SIM_DESC sd, enum disassembler_style style,
+		    const char *fmt, ...)
+{
+  va_list ap;
+  va_start (ap, fmt);
+  sim_io_vprintf (sd, fmt, ap);
+  va_end (ap);
+  return 0;
+}
+
+static uint64_t
+dump_get_64 (const unsigned char *p)
+{
+  uint64_t value = 0;
+  int i;
+
+  for (i = 7; i >= 0; i--)
+    value = (value << 8) | p[i];
+  return value;
+}
+
+/* Print the binary trace in file NAME.  */
+
+static SIM_RC
+trace_binary_dump (SIM_DESC sd, const char *name)
+{
+  const bfd_arch_info_type *arch;
+  disassembler_ftype disasm = NULL;
+  disassemble_info info;
+  unsigned char head[11];
+  unsigned char rec[11 + TRACE_BINARY_MAX_INSN];
+  char arch_name[256];
+  int big_p;
+  FILE *f;
+
+  f = fopen (name, "rb");
+  if (f == NULL)
+    {
+      sim_io_eprintf (sd, "Unable to open binary trace file `%s'\n", name);
+      return SIM_RC_FAIL;
+    }
+
+  if (fread (head, 1, sizeof (head), f) != sizeof (head)
+      || memcmp (head, "SIMTRACE", 8) != 0
+      || head[8] != TRACE_BINARY_VERSION
+      || fread (arch_name, 1, head[10], f) != head[10])
+    {
+      sim_io_eprintf (sd, "`%s' is not a binary trace file\n", name);
+      fclose (f);
+      return SIM_RC_FAIL;
+    }
+  arch_name[head[10]] = '\0';
+  big_p = head[9];
+
+  arch = bfd_scan_arch (arch_name);
+  if (arch != NULL)
+    disasm = disassembler (arch->arch, big_p, arch->mach, NULL);
+  if (disasm != NULL)
+    {
+      INIT_DISASSEMBLE_INFO (info, sd, dump_printf, dump_styled_printf);
+      info.arch = arch->arch;
+      info.mach = arch->mach;
+      info.endian = big_p ? BFD_ENDIAN_BIG : BFD_ENDIAN_LITTLE;
+      info.endian_code = info.endian;
+      disassemble_init_for_target (&info);
+    }
+
+  while (fread (rec, 1, 11, f) == 11)
+    {
+      int nr_bytes = rec[2];
+      uint64_t addr = dump_get_64 (rec + 3);
+      unsigned char *data = rec + 11;
+      int i;
+
+      if (nr_bytes > TRACE_BINARY_MAX_INSN
+	  || fread (data, 1, nr_bytes, f) != nr_bytes)
+	{
+	  sim_io_eprintf (sd, "Truncated binary trace file `%s'\n", name);
+	  break;
+	}
+
+      switch (rec[0])
+	{
+	case TRACE_BINARY_INSN:
+	  sim_io_printf (sd, "%d 0x%08" PRIx64 " ", rec[1], addr);
+	  for (i = 0; i < nr_bytes; i++)
+	    sim_io_printf (sd, "%02x", data[i]);
+	  sim_io_printf (sd, "%*s", i < 8 ? (8 - i) * 2 + 1 : 1, "");
+	  if (disasm != NULL && nr_bytes > 0)
+	    {
+	      info.buffer = data;
+	      info.buffer_vma = addr;
+	      info.buffer_length = nr_bytes;
+	      disasm (addr, &info);
+	    }
+	  sim_io_printf (sd, "\n");
+	  break;
+
+	case TRACE_BINARY_READ:
+	case TRACE_BINARY_WRITE:
+	  sim_io_printf (sd, "    %s-%d %s:0x%08" PRIx64 " %s 0x",
+			 rec[0] == TRACE_BINARY_READ ? "read" : "write",
+			 nr_bytes, map_to_str (rec[1]), addr,
+			 rec[0] == TRACE_BINARY_READ ? "->" : "<-");
+	  for (i = nr_bytes - 1; i >= 0; i--)
+	    sim_io_printf (sd, "%02x", data[i]);
+	  sim_io_printf (sd, "\n");
+	  break;
+
+	default:
+	  sim_io_eprintf (sd, "Bad record %d in binary trace file `%s'\n",
+			  rec[0], name);
+	  fclose (f);
+	  return SIM_RC_FAIL;
+	}
+    }
+
+  fclose (f);
+  return SIM_RC_OK;
+}
+
 
 static SIM_RC
 trace_option_handler (SIM_DESC sd, sim_cpu *cpu, int opt,
@@ -431,6 +786,20 @@ trace_option_handler (SIM_DESC sd, sim_cpu *cpu, int opt,
 	  TRACE_FILE (STATE_TRACE_DATA (sd)) = f;
 	}
       break;
+
+    case OPTION_TRACE_BINARY :
+      if (WITH_TRACE_CORE_P)
+	return trace_binary_open (sd, arg);
+      else
+	sim_io_eprintf (sd, "CORE tracing not compiled in, `--trace-binary' ignored\n");
+      break;
+
+    case OPTION_TRACE_BINARY_DUMP :
+      if (trace_binary_dump (sd, arg) != SIM_RC_OK)
+	return SIM_RC_FAIL;
+      if (STATE_OPEN_KIND (sd) == SIM_OPEN_STANDALONE)
+	exit (0);
+      break;
     }
 
   return SIM_RC_OK;
@@ -491,6 +860,8 @@ trace_uninstall (SIM_DESC sd)
   int i,j;
   FILE *sfile = TRACE_FILE (STATE_TRACE_DATA (sd));
 
+  trace_binary_close (sd);
+
   if (sfile != NULL)
     fclose (sfile);
 
@@ -770,6 +1141,19 @@ trace_prefix (SIM_DESC sd,
   TRACE_IDX (data) = 0;
   TRACE_INPUT_IDX (data) = 0;
 
+  /* In binary mode an instruction is just a record of where it is.  */
+  if (TRACE_BINARY (data) != NULL)
+    {
+      struct trace_binary *tb = TRACE_BINARY (data);
+
+      trace_binary_end_insn (sd, tb);
+      tb->insn_p = 1;
+      tb->insn_cpu = CPU_INDEX (cpu);
+      tb->insn_pc = pc;
+      tb->insn_size = 0;
+      return;
+    }
+
   /* Create the text prefix for this new instruction: */
   if (!line_p)
     {
@@ -877,6 +1261,10 @@ trace_generic (SIM_DESC sd,
 	       ...)
 {
   va_list ap;
+
+  if (TRACE_BINARY (STATE_TRACE_DATA (sd)) != NULL)
+    return;
+
   trace_printf (sd, cpu, "%s %s",
 		trace_idx_to_str (trace_idx),
 		TRACE_PREFIX (CPU_TRACE_DATA (cpu)));
@@ -925,6 +1313,9 @@ trace_disasm (SIM_DESC sd, sim_cpu *cpu, address_word addr)
   TRACE_DATA *trace_data = CPU_TRACE_DATA (cpu);
   disassemble_info *info = &trace_data->dis_info;
 
+  if (TRACE_BINARY (trace_data) != NULL)
+    return;
+
   /* See if we need to set up the disassembly func.  */
   if (trace_data->dis_bfd != bfd)
     {
@@ -1315,6 +1706,10 @@ trace_result_word1_string1 (SIM_DESC sd,
 void
 trace_vprintf (SIM_DESC sd, sim_cpu *cpu, const char *fmt, va_list ap)
 {
+  /* Text output is dropped while tracing in binary.  */
+  if (TRACE_BINARY (STATE_TRACE_DATA (sd)) != NULL)
+    return;
+
   if (cpu != NULL)
     {
       if (TRACE_FILE (CPU_TRACE_DATA (cpu)) != NULL)
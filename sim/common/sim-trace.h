@@ -214,6 +214,12 @@ typedef struct _trace_data {
   /* State used with the disassemble function.
      Meant for use by the internal trace module only.  */
   disassemble_info dis_info;
+
+  /* The binary trace output selected by --trace-binary, shared by the
+     system and all cpus.  While it is set, text trace output is dropped.
+     Meant for use by the internal trace module only.  */
+  struct trace_binary *binary;
+#define TRACE_BINARY(t) ((t)->binary)
 } TRACE_DATA;
 
 /* System tracing support.  */
@@ -279,6 +285,10 @@ typedef struct _trace_data {
 #define TRACE_ANY_P(cpu)	(WITH_TRACE_ANY_P && (CPU_TRACE_DATA (cpu)->trace_any_p))
 #define TRACE_INSN_P(cpu)	TRACE_P (cpu, TRACE_INSN_IDX)
 #define TRACE_DISASM_P(cpu)	TRACE_P (cpu, TRACE_DISASM_IDX)
+
+/* Non-zero if core accesses of CPU go to the binary trace.  */
+#define TRACE_BINARY_P(cpu) \
+  (WITH_TRACE_CORE_P && TRACE_BINARY (CPU_TRACE_DATA (cpu)) != NULL)
 #define TRACE_DECODE_P(cpu)	TRACE_P (cpu, TRACE_DECODE_IDX)
 #define TRACE_EXTRACT_P(cpu)	TRACE_P (cpu, TRACE_EXTRACT_IDX)
 #define TRACE_LINENUM_P(cpu)	TRACE_P (cpu, TRACE_LINENUM_IDX)
@@ -348,6 +358,18 @@ extern void trace_generic (SIM_DESC sd,
 
 extern void trace_disasm (SIM_DESC sd, sim_cpu *cpu, address_word addr);
 
+/* Append a core access of NR_BYTES at ADDR to the binary trace.  The
+   value is passed as its least and most significant 64 bits.  Accesses
+   through exec_map become the opcode bytes of the current instruction.  */
+
+extern void trace_binary_core (sim_cpu *cpu,
+			       transfer_type type,
+			       unsigned map,
+			       address_word addr,
+			       uint64_t lo,
+			       uint64_t hi,
+			       int nr_bytes);
+
 typedef enum {
   trace_fmt_invalid,
   trace_fmt_word,
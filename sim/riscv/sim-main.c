@@ -445,12 +445,16 @@ execute_i (SIM_CPU *cpu, unsigned_word iw, const struct riscv_opcode *op)
       store_rd (cpu, rd, riscv_cpu->pc + 4);
       pc = riscv_cpu->pc + EXTRACT_JTYPE_IMM (iw);
       TRACE_BRANCH (cpu, "to %#" PRIxTW, pc);
+      if (rd == X_RA || rd == X_T0)
+	PROFILE_COUNT_CALL (cpu, riscv_cpu->pc, pc);
       break;
     case MATCH_JALR:
       TRACE_INSN (cpu, "jalr %s, %s, %" PRIiTW ";", rd_name, rs1_name, i_imm);
       pc = riscv_cpu->regs[rs1] + i_imm;
       store_rd (cpu, rd, riscv_cpu->pc + 4);
       TRACE_BRANCH (cpu, "to %#" PRIxTW, pc);
+      if (rd == X_RA || rd == X_T0)
+	PROFILE_COUNT_CALL (cpu, riscv_cpu->pc, pc);
       break;
 
     case MATCH_LD:
@@ -0,0 +1,90 @@
+# Blackfin testcase for IDLE waking up on a core timer interrupt
+# The clock should jump straight to the timer expiring, with the idle
+# cycles still counted in CYCLES.
+# mach: bfin
+# sim: --environment operating
+
+	.include "testutils.inc"
+
+	.macro wr_mmr addr:req, val:req
+	imm32 p0, \addr
+	imm32 r0, \val
+	[p0] = r0;
+	.endm
+
+	.equ EVT6, 0xFFE02018
+	.equ EVT15, 0xFFE0203C
+	.equ TCNTL, 0xFFE03000
+	.equ TPERIOD, 0xFFE03004
+	.equ TSCALE, 0xFFE03008
+	.equ TCOUNT, 0xFFE0300c
+	.equ PERIOD, 0x10000000
+
+	start
+
+	loadsym sp, KSTACK;
+
+	CLI r1;
+	imm32 p0, EVT6;
+	loadsym r0, THANDLE;
+	[p0] = r0;
+	imm32 p0, EVT15;
+	loadsym r0, BEGIN;
+	[p0] = r0;
+	csync;
+	r1 = -1;
+	sti r1;
+
+	/* Continue in IVG15, where the timer interrupt can preempt us.  */
+	RAISE 15;
+	loadsym r0, BEGIN;
+	RETI = r0;
+	RTI;
+
+BEGIN:
+	[--sp] = RETI;	// enable nested interrupts
+
+	r7 = 0;
+	CYCLES = r7;
+	CYCLES2 = r7;
+
+	wr_mmr TCNTL, 1
+	wr_mmr TSCALE, 0
+	wr_mmr TPERIOD, PERIOD
+	wr_mmr TCOUNT, PERIOD
+	wr_mmr TCNTL, 3
+	csync;
+
+1:
+	idle;
+	CC = r7 == 0;
+	if CC jump 1b;
+
+	r2 = CYCLES;
+	r3 = CYCLES2;
+
+	/* The timer fired exactly once...  */
+	CC = r7 == 1;
+	if ! CC jump 2f;
+
+	/* ... and not before the whole period had gone by.  */
+	CC = r3 == 0;
+	if ! CC jump 3f;
+	imm32 r1, PERIOD;
+	CC = r1 <= r2 (IU);
+	if ! CC jump 2f;
+3:
+	pass
+2:
+	fail
+
+THANDLE:
+	r7 += 1;
+	wr_mmr TCNTL, 1
+	csync;
+	RTI;
+
+	.data
+	.align 4
+	.space 0x100
+KSTACK:
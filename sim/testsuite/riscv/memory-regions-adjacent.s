@@ -0,0 +1,35 @@
+# Check loads and stores to memory regions that abut each other.
+# mach: riscv
+# sim: --memory-region 0x10000000,0x100 --memory-region 0x10000100,0x100
+
+.include "testutils.inc"
+
+	start
+
+	li	t1, 0x10000000		# First region.
+	li	t2, 0x10000100		# Second region.
+
+	li	t0, 0x11
+	sb	t0, 0(t1)
+	li	t0, 0x22
+	sb	t0, 0xff(t1)
+	li	t0, 0x33
+	sb	t0, 0(t2)
+	li	t0, 0x44
+	sb	t0, 0xff(t2)
+
+	lbu	t3, 0(t1)
+	li	t4, 0x11
+	bne	t3, t4, 1f
+	lbu	t3, 0xff(t1)
+	li	t4, 0x22
+	bne	t3, t4, 1f
+	lbu	t3, 0(t2)
+	li	t4, 0x33
+	bne	t3, t4, 1f
+	lbu	t3, 0xff(t2)
+	li	t4, 0x44
+	bne	t3, t4, 1f
+	pass
+1:
+	fail
@@ -0,0 +1,31 @@
+# Check loads and stores to the last of many memory regions.
+# Every access used to walk the regions in front of it, so this also
+# serves as a benchmark of sim-core's address lookup: raise the loop
+# count and time the run.
+# mach: riscv
+# sim: --memory-region 0x10000000,0x100 --memory-region 0x10010000,0x100 --memory-region 0x10020000,0x100 --memory-region 0x10030000,0x100 --memory-region 0x10040000,0x100 --memory-region 0x10050000,0x100 --memory-region 0x10060000,0x100 --memory-region 0x10070000,0x100 --memory-region 0x10080000,0x100 --memory-region 0x10090000,0x100 --memory-region 0x100a0000,0x100 --memory-region 0x100b0000,0x100 --memory-region 0x100c0000,0x100 --memory-region 0x100d0000,0x100 --memory-region 0x100e0000,0x100 --memory-region 0x100f0000,0x100 --memory-region 0x10100000,0x100 --memory-region 0x10110000,0x100 --memory-region 0x10120000,0x100 --memory-region 0x10130000,0x100 --memory-region 0x10140000,0x100 --memory-region 0x10150000,0x100 --memory-region 0x10160000,0x100 --memory-region 0x10170000,0x100 --memory-region 0x10180000,0x100 --memory-region 0x10190000,0x100 --memory-region 0x101a0000,0x100 --memory-region 0x101b0000,0x100 --memory-region 0x101c0000,0x100 --memory-region 0x101d0000,0x100 --memory-region 0x101e0000,0x100 --memory-region 0x101f0000,0x100
+
+.include "testutils.inc"
+
+	start
+
+	li	t0, 60000		# Iterations.
+	li	t1, 0x101f0000		# Last region.
+	li	t2, 0			# Running sum.
+1:
+	sw	t0, 0x80(t1)
+	lw	t3, 0x80(t1)
+	add	t2, t2, t3
+	sb	t0, 0xff(t1)
+	lbu	t3, 0xff(t1)
+	andi	t4, t0, 0xff
+	bne	t3, t4, 2f
+	addi	t0, t0, -1
+	bnez	t0, 1b
+
+	# 1 + 2 + ... + 60000.
+	li	t4, 1800030000
+	bne	t2, t4, 2f
+	pass
+2:
+	fail